@@ -4,7 +4,12 @@
 #ifndef SUBSTATE_MAPPINGNODE_H
 #define SUBSTATE_MAPPINGNODE_H
 
-#include <map>
+#include <vector>
+#include <utility>
+#include <initializer_list>
+#include <algorithm>
+
+#include <substate/ArrayView.h>
 
 #include <qsubstate/Property.h>
 
@@ -12,59 +17,98 @@ namespace ss {
 
     class MappingAction;
 
+    class MappingBatchAction;
+
     class MappingNodePrivate;
 
-    /// MappingNode - Vector data structure node.
+    /// MappingNode - Mapping data structure node.
+    /// \note The entries are stored in a flat array sorted by the id of the interned key, so the
+    /// iteration order follows the order in which the keys were first interned, which may differ
+    /// between processes. Reading by name never interns it, assigning by name does.
     class QSUBSTATE_EXPORT MappingNode : public Node {
     public:
+        using Entry = std::pair<PropertyKey, Property>;
+
         inline explicit MappingNode(int type = Mapping);
         ~MappingNode();
 
     public:
-        inline Property property(const QString &key) const;
-        bool setProperty(const QString &key, const Property &value);
-        inline const std::map<QString, Property> &data() const;
+        inline Property property(const PropertyKey &key) const;
+        inline Property property(const QString &name) const;
+        bool setProperty(const PropertyKey &key, const Property &value);
+        inline bool setProperty(const QString &name, const Property &value);
+        bool setProperties(ArrayView<Entry> values); // One action, the last value of a key wins
+        bool setProperties(std::initializer_list<std::pair<QString, Property>> values);
+        inline ArrayView<Entry> data() const;
         inline int count() const;
         inline int size() const;
 
     protected:
         std::shared_ptr<Node> clone(bool copyId) const override;
-        void propagateChildren(const std::function<void(Node *)> &func) override;
+        void collectChildren(std::vector<Node *> &children) const override;
+        void hashContent(ContentHasher &hasher) const override;
+
+        inline std::vector<Entry>::const_iterator lowerBound(const PropertyKey &key) const;
+        void assign(const PropertyKey &key, const Property &value);
+        void assign(ArrayView<PropertyKey> keys, ArrayView<Property> values);
 
-        std::map<QString, Property> _map;
+        std::vector<Entry> _entries;
 
         friend class MappingNodePrivate;
         friend class MappingAction;
+        friend class MappingBatchAction;
     };
 
     inline MappingNode::MappingNode(int type) : Node(type) {
     }
 
-    inline Property MappingNode::property(const QString &key) const {
-        auto it = _map.find(key);
-        if (it == _map.end()) {
+    inline Property MappingNode::property(const PropertyKey &key) const {
+        auto it = lowerBound(key);
+        if (it == _entries.end() || it->first != key) {
             return {};
         }
         return it->second;
     }
 
-    inline const std::map<QString, Property> &MappingNode::data() const {
-        return _map;
+    inline Property MappingNode::property(const QString &name) const {
+        auto key = PropertyKey::find(name);
+        if (!key.isValid()) {
+            return {};
+        }
+        return property(key);
+    }
+
+    inline bool MappingNode::setProperty(const QString &name, const Property &value) {
+        // Removing a name that has never been interned changes nothing
+        auto key = value.isValid() ? PropertyKey(name) : PropertyKey::find(name);
+        return key.isValid() && setProperty(key, value);
+    }
+
+    inline ArrayView<MappingNode::Entry> MappingNode::data() const {
+        return _entries;
     }
 
     inline int MappingNode::count() const {
-        return int(_map.size());
+        return int(_entries.size());
     }
 
     inline int MappingNode::size() const {
-        return int(_map.size());
+        return int(_entries.size());
+    }
+
+    inline std::vector<MappingNode::Entry>::const_iterator
+        MappingNode::lowerBound(const PropertyKey &key) const {
+        return std::lower_bound(_entries.begin(), _entries.end(), key,
+                                [](const Entry &entry, const PropertyKey &key) {
+                                    return entry.first < key; //
+                                });
     }
 
 
     /// MappingAction - Action for \c MappingNode operations.
     class QSUBSTATE_EXPORT MappingAction : public PropertyAction {
     public:
-        inline MappingAction(const std::shared_ptr<MappingNode> &parent, QString key,
+        inline MappingAction(const std::shared_ptr<MappingNode> &parent, const PropertyKey &key,
                              Property oldValue, Property value);
         ~MappingAction();
 
@@ -72,22 +116,67 @@ namespace ss {
         void execute(bool undo) override;
 
     public:
-        inline QString key() const;
+        inline PropertyKey key() const;
 
     public:
-        QString _key;
+        PropertyKey _key;
     };
 
-    inline MappingAction::MappingAction(const std::shared_ptr<MappingNode> &parent, QString key,
-                                        Property oldValue, Property value)
-        : PropertyAction(MappingAssign, parent, std::move(oldValue), std::move(value)),
-          _key(std::move(key)) {
+    inline MappingAction::MappingAction(const std::shared_ptr<MappingNode> &parent,
+                                        const PropertyKey &key, Property oldValue, Property value)
+        : PropertyAction(MappingAssign, parent, std::move(oldValue), std::move(value)), _key(key) {
     }
 
-    inline QString MappingAction::key() const {
+    inline PropertyKey MappingAction::key() const {
         return _key;
     }
 
+
+    /// MappingBatchAction - Action for \c MappingNode assignment of multiple keys at once.
+    class QSUBSTATE_EXPORT MappingBatchAction : public NodeAction {
+    public:
+        inline MappingBatchAction(const std::shared_ptr<MappingNode> &parent,
+                                  std::vector<PropertyKey> keys, std::vector<Property> oldValues,
+                                  std::vector<Property> values);
+        ~MappingBatchAction();
+
+    public:
+        void queryNodes(bool inserted,
+                        const std::function<void(const std::shared_ptr<Node> &)> &add) override;
+        void execute(bool undo) override;
+
+    public:
+        /// Returns the changed keys in ascending id order, parallel to the values.
+        inline ArrayView<PropertyKey> keys() const;
+        inline ArrayView<Property> oldValues() const;
+        inline ArrayView<Property> values() const;
+
+    protected:
+        std::vector<PropertyKey> _keys;
+        std::vector<Property> _oldValues;
+        std::vector<Property> _values;
+    };
+
+    inline MappingBatchAction::MappingBatchAction(const std::shared_ptr<MappingNode> &parent,
+                                                  std::vector<PropertyKey> keys,
+                                                  std::vector<Property> oldValues,
+                                                  std::vector<Property> values)
+        : NodeAction(MappingAssignMany, parent), _keys(std::move(keys)),
+          _oldValues(std::move(oldValues)), _values(std::move(values)) {
+    }
+
+    inline ArrayView<PropertyKey> MappingBatchAction::keys() const {
+        return _keys;
+    }
+
+    inline ArrayView<Property> MappingBatchAction::oldValues() const {
+        return _oldValues;
+    }
+
+    inline ArrayView<Property> MappingBatchAction::values() const {
+        return _values;
+    }
+
 }
 
 #endif // SUBSTATE_MAPPINGNODE_H
\ No newline at end of file
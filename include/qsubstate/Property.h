@@ -4,6 +4,11 @@
 #ifndef SUBSTATE_PROPERTY_H
 #define SUBSTATE_PROPERTY_H
 
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include <QtCore/QString>
 #include <QtCore/QVariant>
 
 #include <substate/Node.h>
@@ -13,7 +18,73 @@
 
 namespace ss {
 
+    /// PropertyKey - Interned property name, stored and compared as an integer id.
+    /// \note Ids are assigned in the order the names are first seen, which depends on the process,
+    /// so they are only meaningful within the current process. Constructing a key from a name
+    /// interns the name for good, use \c find() to look up a name that may be unknown. Keep
+    /// frequently used keys in static variables to avoid the lookup on every access.
+    class QSUBSTATE_EXPORT PropertyKey {
+    public:
+        inline PropertyKey();
+        explicit PropertyKey(const QString &name);
+        inline explicit PropertyKey(const char *name);
+
+        inline int id() const;
+        inline bool isValid() const;
+        QString name() const;
+
+        static inline PropertyKey fromId(int id);
+
+        /// Returns the key of \a name without interning it, the key is invalid if the name has
+        /// never been interned.
+        static PropertyKey find(const QString &name);
+
+    public:
+        inline bool operator==(const PropertyKey &other) const;
+        inline bool operator!=(const PropertyKey &other) const;
+        inline bool operator<(const PropertyKey &other) const;
+
+    protected:
+        int _id;
+    };
+
+    inline PropertyKey::PropertyKey() : _id(-1) {
+    }
+
+    inline PropertyKey::PropertyKey(const char *name) : PropertyKey(QString::fromUtf8(name)) {
+    }
+
+    inline int PropertyKey::id() const {
+        return _id;
+    }
+
+    inline bool PropertyKey::isValid() const {
+        return _id >= 0;
+    }
+
+    inline PropertyKey PropertyKey::fromId(int id) {
+        PropertyKey key;
+        key._id = id;
+        return key;
+    }
+
+    inline bool PropertyKey::operator==(const PropertyKey &other) const {
+        return _id == other._id;
+    }
+
+    inline bool PropertyKey::operator!=(const PropertyKey &other) const {
+        return _id != other._id;
+    }
+
+    inline bool PropertyKey::operator<(const PropertyKey &other) const {
+        return _id < other._id;
+    }
+
+
     /// Property - Container of \c Node or \c Variant instance.
+    /// \note Booleans, integers, doubles and strings of at most \c ShortStringCapacity UTF-16 units
+    /// are stored inline rather than in a \c QVariant, they're still reported as \c Variant. Values
+    /// of these types are compared by type first, so an integer never equals a double.
     class QSUBSTATE_EXPORT Property {
     public:
         enum Type {
@@ -22,81 +93,249 @@ namespace ss {
             Variant,
         };
 
+        static constexpr const int ShortStringCapacity = 8;
+
         inline Property();
         inline Property(const std::shared_ptr<class Node> &node);
-        inline Property(const QVariant &variant);
-        ~Property();
-
-        Property(const Property &RHS);
-        Property(Property &&RHS);
-        Property &operator=(const Property &RHS);
-        Property &operator=(Property &&RHS);
+        Property(const QVariant &variant);
+        template <class T, class = std::enable_if_t<std::is_same_v<T, bool> ||
+                                                    std::is_same_v<T, int> ||
+                                                    std::is_same_v<T, double>>>
+        inline Property(T value); // Exact types only, never a pointer or size converted to bool
+        Property(const QString &s);
+        inline Property(const char *s);
+        inline ~Property();
+
+        inline Property(const Property &RHS);
+        inline Property(Property &&RHS) noexcept;
+        inline Property &operator=(const Property &RHS);
+        inline Property &operator=(Property &&RHS) noexcept;
 
         inline Type type() const;
         inline bool isValid() const;
         inline bool isVariant() const;
         inline bool isNode() const;
 
-        inline QVariant variant() const;
+        QVariant variant() const;
         inline std::shared_ptr<class Node> node() const;
+        inline const std::shared_ptr<class Node> &nodeRef() const; // Null if it's not a node
+
+        /// Returns the value converted to the given type, the inline types skip \c QVariant.
+        inline bool toBool() const;
+        inline int toInt() const;
+        inline double toDouble() const;
+        QString toString() const;
+
+        /// Feeds the property into \a hasher, a node property only adds its type.
+        void hashContent(ContentHasher &hasher) const;
 
     public:
-        bool operator==(const Property &other) const;
+        inline bool operator==(const Property &other) const;
         inline bool operator!=(const Property &other) const;
 
+        /// Returns whether the properties are identical, like \c operator== except that doubles
+        /// are compared by their bits, so that a NaN is the same as itself and -0.0 differs from
+        /// 0.0.
+        inline bool isSame(const Property &other) const;
+
     protected:
+        enum Kind : uint8_t {
+            InvalidKind,
+            NodeKind,
+            VariantKind,
+            // Trivially copyable kinds
+            BoolKind,
+            IntKind,
+            DoubleKind,
+            StringKind,
+        };
+
         union Storage {
             std::shared_ptr<class Node> node;
             QVariant var;
+            bool b;
+            int i;
+            double d;
+            char16_t str[ShortStringCapacity];
 
             Storage(){};
             ~Storage(){};
         };
         Storage _storage;
-        Type _type;
+        Kind _kind;
+        uint8_t _length; // Length of the short string
+
+        inline bool isTrivial() const;
+        inline void copyTrivial(const Property &RHS);
+        void initString(const QString &s);
+        void copy(const Property &RHS);
+        void move(Property &&RHS);
+        void destroy();
+        bool equals(const Property &other) const;
 
         friend class NodeHelper;
     };
 
-    inline Property::Property() : _type(Invalid) {
+    inline Property::Property() : _kind(InvalidKind), _length(0) {
     }
 
-    inline Property::Property(const std::shared_ptr<class Node> &node) : _type(Node) {
+    inline Property::Property(const std::shared_ptr<class Node> &node)
+        : _kind(NodeKind), _length(0) {
         new (&_storage.node) std::shared_ptr<class Node>(node);
     }
 
-    inline Property::Property(const QVariant &variant) : _type(Variant) {
-        new (&_storage.var) QVariant(variant);
+    template <class T, class>
+    inline Property::Property(T value) : _length(0) {
+        if constexpr (std::is_same_v<T, bool>) {
+            _kind = BoolKind;
+            _storage.b = value;
+        } else if constexpr (std::is_same_v<T, int>) {
+            _kind = IntKind;
+            _storage.i = value;
+        } else {
+            _kind = DoubleKind;
+            _storage.d = value;
+        }
+    }
+
+    inline Property::Property(const char *s) : Property(QString::fromUtf8(s)) {
+    }
+
+    inline Property::~Property() {
+        if (!isTrivial()) {
+            destroy();
+        }
+    }
+
+    inline Property::Property(const Property &RHS) : _kind(RHS._kind), _length(RHS._length) {
+        if (isTrivial()) {
+            copyTrivial(RHS);
+        } else {
+            copy(RHS);
+        }
+    }
+
+    inline Property::Property(Property &&RHS) noexcept : _kind(RHS._kind), _length(RHS._length) {
+        if (isTrivial()) {
+            copyTrivial(RHS);
+        } else {
+            move(std::move(RHS));
+        }
+    }
+
+    inline Property &Property::operator=(const Property &RHS) {
+        if (this != &RHS) {
+            if (!isTrivial()) {
+                destroy();
+            }
+            _kind = RHS._kind;
+            _length = RHS._length;
+            if (isTrivial()) {
+                copyTrivial(RHS);
+            } else {
+                copy(RHS);
+            }
+        }
+        return *this;
+    }
+
+    inline Property &Property::operator=(Property &&RHS) noexcept {
+        if (this != &RHS) {
+            if (!isTrivial()) {
+                destroy();
+            }
+            _kind = RHS._kind;
+            _length = RHS._length;
+            if (isTrivial()) {
+                copyTrivial(RHS);
+            } else {
+                move(std::move(RHS));
+            }
+        }
+        return *this;
     }
 
     inline Property::Type Property::type() const {
-        return _type;
+        switch (_kind) {
+            case InvalidKind:
+                return Invalid;
+            case NodeKind:
+                return Node;
+            default:
+                break;
+        }
+        return Variant;
     }
 
     inline bool Property::isValid() const {
-        return _type != Invalid;
+        return _kind != InvalidKind;
     }
 
     inline bool Property::isVariant() const {
-        return _type == Variant;
+        return _kind >= VariantKind;
     }
 
     inline bool Property::isNode() const {
-        return _type == Node;
+        return _kind == NodeKind;
     }
 
-    inline QVariant Property::variant() const {
-        return _type == Variant ? _storage.var : QVariant();
+    inline std::shared_ptr<class Node> Property::node() const {
+        return _kind == NodeKind ? _storage.node : std::shared_ptr<class Node>();
     }
 
-    inline std::shared_ptr<class Node> Property::node() const {
-        return _type == Node ? _storage.node : std::shared_ptr<class Node>();
+    inline const std::shared_ptr<class Node> &Property::nodeRef() const {
+        static const std::shared_ptr<class Node> null;
+        return _kind == NodeKind ? _storage.node : null;
+    }
+
+    inline bool Property::toBool() const {
+        return _kind == BoolKind ? _storage.b : variant().toBool();
+    }
+
+    inline int Property::toInt() const {
+        return _kind == IntKind ? _storage.i : variant().toInt();
+    }
+
+    inline double Property::toDouble() const {
+        return _kind == DoubleKind ? _storage.d : variant().toDouble();
+    }
+
+    inline bool Property::operator==(const Property &other) const {
+        if (_kind != other._kind)
+            return false;
+        switch (_kind) {
+            case InvalidKind:
+                return true;
+            case BoolKind:
+                return _storage.b == other._storage.b;
+            case IntKind:
+                return _storage.i == other._storage.i;
+            case DoubleKind:
+                return _storage.d == other._storage.d;
+            default:
+                break;
+        }
+        return equals(other);
     }
 
     inline bool Property::operator!=(const Property &other) const {
         return !(*this == other);
     }
 
+    inline bool Property::isSame(const Property &other) const {
+        if (_kind == DoubleKind && other._kind == DoubleKind)
+            return std::memcmp(&_storage.d, &other._storage.d, sizeof(double)) == 0;
+        return *this == other;
+    }
+
+    inline bool Property::isTrivial() const {
+        return _kind == InvalidKind || _kind >= BoolKind;
+    }
+
+    inline void Property::copyTrivial(const Property &RHS) {
+        std::memcpy(static_cast<void *>(&_storage), &RHS._storage, sizeof(Storage));
+    }
+
 
     /// PropertyAction - Action for property change.
     class QSUBSTATE_EXPORT PropertyAction : public NodeAction {
@@ -120,15 +359,15 @@ namespace ss {
 
     inline PropertyAction::PropertyAction(Type type, const std::shared_ptr<Node> &parent,
                                           Property oldValue, Property value)
-        : NodeAction(type, parent), _value(std::move(oldValue)), _oldValue(std::move(value)) {
+        : NodeAction(type, parent), _oldValue(std::move(oldValue)), _value(std::move(value)) {
     }
 
-    const Property &PropertyAction::oldValue() const {
-        return _value;
+    inline const Property &PropertyAction::oldValue() const {
+        return _oldValue;
     }
 
-    const Property &PropertyAction::value() const {
-        return _oldValue;
+    inline const Property &PropertyAction::value() const {
+        return _value;
     }
 
 }
@@ -4,6 +4,9 @@
 #ifndef SUBSTATE_STRUCTNODE_H
 #define SUBSTATE_STRUCTNODE_H
 
+#include <vector>
+#include <utility>
+
 #include <substate/ArrayView.h>
 
 #include <qsubstate/Property.h>
@@ -12,6 +15,8 @@ namespace ss {
 
     class StructAction;
 
+    class StructBatchAction;
+
     class StructNodeBasePrivate;
 
     /// StructNode - MappingNode - Base struct data structure node base.
@@ -23,13 +28,16 @@ namespace ss {
     public:
         inline const Property &at(int index) const;
         void setAt(int index, Property value);
+        void setAt(int index, ArrayView<Property> values); // Assigns [index, index + values.size())
+        void setAt(ArrayView<std::pair<int, Property>> values); // The last value of an index wins
 
         inline ArrayView<Property> data() const;
         inline int count() const;
         inline int size() const;
 
     protected:
-        void propagateChildren(const std::function<void(Node *)> &func) override;
+        void collectChildren(std::vector<Node *> &children) const override;
+        void hashContent(ContentHasher &hasher) const override;
 
     protected:
         Property *_storage;
@@ -37,8 +45,11 @@ namespace ss {
 
         static void copy(StructNodeBase *dest, const StructNodeBase *src, bool copyId);
 
+        void setMany(std::vector<int> indexes, std::vector<Property> values);
+
         friend class StructNodeBasePrivate;
         friend class StructAction;
+        friend class StructBatchAction;
     };
 
     inline StructNodeBase::StructNodeBase(int type, Property *storage, size_t size)
@@ -67,7 +78,7 @@ namespace ss {
     class StructNode : public StructNodeBase {
     public:
         inline StructNode(int type);
-        ~StructNode() = default;
+        ~StructNode();
 
     protected:
         std::shared_ptr<Node> clone(bool copyId) const override;
@@ -80,6 +91,11 @@ namespace ss {
     inline StructNode<N>::StructNode(int type) : StructNodeBase(type, _buf, N) {
     }
 
+    template <size_t N>
+    StructNode<N>::~StructNode() {
+        deferChildren();
+    }
+
     template <size_t N>
     inline std::shared_ptr<Node> StructNode<N>::clone(bool copyId) const {
         auto node = std::make_shared<StructNode<N>>(_type);
@@ -115,6 +131,52 @@ namespace ss {
         return _index;
     }
 
+
+    /// StructBatchAction - Action for \c StructNode assignment of multiple fields at once.
+    class QSUBSTATE_EXPORT StructBatchAction : public NodeAction {
+    public:
+        inline StructBatchAction(const std::shared_ptr<StructNodeBase> &parent,
+                                 std::vector<int> indexes, std::vector<Property> oldValues,
+                                 std::vector<Property> values);
+        ~StructBatchAction();
+
+    public:
+        void queryNodes(bool inserted,
+                        const std::function<void(const std::shared_ptr<Node> &)> &add) override;
+        void execute(bool undo) override;
+
+    public:
+        /// Returns the changed indexes in ascending order, parallel to the values.
+        inline ArrayView<int> indexes() const;
+        inline ArrayView<Property> oldValues() const;
+        inline ArrayView<Property> values() const;
+
+    protected:
+        std::vector<int> _indexes;
+        std::vector<Property> _oldValues;
+        std::vector<Property> _values;
+    };
+
+    inline StructBatchAction::StructBatchAction(const std::shared_ptr<StructNodeBase> &parent,
+                                                std::vector<int> indexes,
+                                                std::vector<Property> oldValues,
+                                                std::vector<Property> values)
+        : NodeAction(StructAssignMany, parent), _indexes(std::move(indexes)),
+          _oldValues(std::move(oldValues)), _values(std::move(values)) {
+    }
+
+    inline ArrayView<int> StructBatchAction::indexes() const {
+        return _indexes;
+    }
+
+    inline ArrayView<Property> StructBatchAction::oldValues() const {
+        return _oldValues;
+    }
+
+    inline ArrayView<Property> StructBatchAction::values() const {
+        return _values;
+    }
+
 }
 
 #endif // SUBSTATE_STRUCTNODE_H
\ No newline at end of file
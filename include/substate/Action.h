@@ -5,15 +5,17 @@
 #define SUBSTATE_ACTION_H
 
 #include <memory>
+#include <utility>
 #include <functional>
 #include <iostream>
 
 #include <substate/Notification.h>
 #include <substate/Node.h>
+#include <substate/MemoryPool.h>
 
 namespace ss {
 
-    class Action {
+    class SUBSTATE_EXPORT Action {
     public:
         enum Type {
             RootChange = 1,
@@ -27,6 +29,30 @@ namespace ss {
             BytesRemove,
             MappingAssign,
             StructAssign,
+            VectorRemoveRanges,
+            VectorMoveRanges,
+            SheetInsertMany,
+            TimelineInsert,
+            TimelineRemove,
+            TimelineReposition,
+            TypedStructAssign,
+            DictAssign,
+            RecordAssign,
+            MappingAssignMany,
+            StructAssignMany,
+            ArrayInsert,
+            ArrayRemove,
+            ArrayReplace,
+            ArrayTransform,
+            TextInsert,
+            TextRemove,
+            SparseVectorInsert,
+            SparseVectorRemove,
+            SparseVectorMove,
+            SparseVectorReplace,
+            SortedInsert,
+            SortedRemove,
+            SortedRekey,
         };
 
         /// Default constructor creates an invalid action.
@@ -45,10 +71,25 @@ namespace ss {
         /// Undo or redo the action.
         virtual void execute(bool undo) = 0;
 
+    public:
+        /// Creates an action of type \a T in \a arena, or on the heap if \a arena is null.
+        template <class T, class... Args>
+        static inline std::unique_ptr<T> create(ActionArena *arena, Args &&...args);
+
+        static void *operator new(size_t size);
+        static void *operator new(size_t size, ActionArena *arena);
+        static void operator delete(void *ptr);
+        static void operator delete(void *ptr, ActionArena *arena);
+
     protected:
         int _type;
     };
 
+    template <class T, class... Args>
+    inline std::unique_ptr<T> Action::create(ActionArena *arena, Args &&...args) {
+        return std::unique_ptr<T>(new (arena) T(std::forward<Args>(args)...));
+    }
+
     inline Action::Action(int type) : _type(type) {
     }
 
@@ -64,6 +105,7 @@ namespace ss {
         ~NodeAction() = default;
 
         inline std::shared_ptr<Node> parent() const;
+        inline Node *parentNode() const;
 
     protected:
         std::shared_ptr<Node> _parent;
@@ -77,6 +119,10 @@ namespace ss {
         return _parent;
     }
 
+    inline Node *NodeAction::parentNode() const {
+        return _parent.get();
+    }
+
 
     /// RootChangeAction - Action for model root change.
     class SUBSTATE_EXPORT RootChangeAction : public Action {
@@ -113,23 +159,31 @@ namespace ss {
 
 
     /// ActionNotification - Notification carrying an action.
+    /// \note When \c isUndo() returns true the action is being reverted, so its old and new
+    /// states are swapped, e.g. an insertion removes its children.
     class ActionNotification : public Notification {
     public:
-        inline ActionNotification(Type type, const Action *action);
+        inline ActionNotification(Type type, const Action *action, bool undo = false);
         ~ActionNotification() = default;
 
         inline const Action *action() const;
+        inline bool isUndo() const;
 
     protected:
         const Action *_action;
+        bool _undo;
     };
 
+    inline ActionNotification::ActionNotification(Type type, const Action *action, bool undo)
+        : Notification(type), _action(action), _undo(undo) {
+    }
+
     inline const Action *ActionNotification::action() const {
         return _action;
     }
 
-    ActionNotification::ActionNotification(Type type, const Action *action)
-        : Notification(type), _action(action) {
+    inline bool ActionNotification::isUndo() const {
+        return _undo;
     }
 
 
@@ -0,0 +1,142 @@
+// Copyright (C) 2022-2025 Stdware Collections (https://www.github.com/stdware)
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef SUBSTATE_AGGREGATE_H
+#define SUBSTATE_AGGREGATE_H
+
+#include <vector>
+#include <cassert>
+#include <utility>
+
+#include <substate/Node.h>
+
+namespace ss {
+
+    class Model;
+
+    /// AggregateRecord - Cached value of an aggregate attached to a node.
+    class AggregateRecord {
+    public:
+        virtual ~AggregateRecord() = default;
+
+        AggregateRecord *next = nullptr;
+        size_t serial = 0; // Serial of the owning aggregate
+        bool valid = false;
+    };
+
+    /// AggregateBase - Type-independent part of \c Aggregate.
+    /// \note The aggregate is registered to the model while it's alive, the model drops the cached
+    /// values of a node and its ancestors every time an action on the node is executed, including
+    /// undo and redo.
+    class SUBSTATE_EXPORT AggregateBase {
+    public:
+        explicit AggregateBase(Model *model);
+        virtual ~AggregateBase();
+
+        AggregateBase(const AggregateBase &) = delete;
+        AggregateBase &operator=(const AggregateBase &) = delete;
+
+    public:
+        /// Returns the model, or null if the model has been destroyed.
+        inline Model *model() const;
+
+        /// Drops the cached values of \a node and its ancestors.
+        void invalidate(const Node *node);
+
+    protected:
+        AggregateRecord *record(const Node *node) const;
+        void attach(const Node *node, AggregateRecord *record);
+
+        /// Collects \a node and its descendants that have no valid cached value, every node comes
+        /// after its parent.
+        void collectStale(const Node *node, std::vector<const Node *> &nodes) const;
+
+        static void collectChildren(const Node *node, std::vector<Node *> &children);
+
+        Model *_model;
+        size_t _serial;
+
+        friend class Model;
+    };
+
+    inline Model *AggregateBase::model() const {
+        return _model;
+    }
+
+
+    /// Aggregate - Summary of every subtree of a model, cached on the nodes.
+    /// \tparam T - The type of the summary.
+    ///
+    /// The summary of a node is its own \c local summary combined with the summaries of its
+    /// children from left to right, in the order of \c Node::collectChildren. A node whose cached
+    /// summary is valid is answered at once, otherwise only the changed branches are computed
+    /// again.
+    ///
+    /// \note Nodes of other models must not be queried, and the caches aren't thread-safe.
+    template <class T>
+    class Aggregate : public AggregateBase {
+    public:
+        inline explicit Aggregate(Model *model);
+
+    public:
+        /// Returns the summary of the own content of \a node, usually by its \c Node::type().
+        virtual T local(const Node *node) const = 0;
+
+        /// Combines two adjacent summaries.
+        virtual T combine(const T &a, const T &b) const = 0;
+
+        /// Returns the summary of the subtree of \a node.
+        T value(const Node *node);
+
+    protected:
+        struct Record : public AggregateRecord {
+            inline explicit Record(T value) : value(std::move(value)) {
+            }
+            T value;
+        };
+    };
+
+    template <class T>
+    inline Aggregate<T>::Aggregate(Model *model) : AggregateBase(model) {
+    }
+
+    template <class T>
+    T Aggregate<T>::value(const Node *node) {
+        assert(!node->model() || node->model() == _model);
+
+        if (auto rec = static_cast<Record *>(record(node)); rec && rec->valid) {
+            return rec->value;
+        }
+
+        // Compute the stale nodes from the bottom up, the valid children are read from the cache
+        std::vector<const Node *> nodes;
+        collectStale(node, nodes);
+
+        std::vector<Node *> children;
+        for (auto it = nodes.rbegin(); it != nodes.rend(); ++it) {
+            auto n = *it;
+            T res = local(n);
+
+            children.clear();
+            collectChildren(n, children);
+            for (const auto &child : std::as_const(children)) {
+                auto childRec = static_cast<Record *>(record(child));
+                assert(childRec && childRec->valid);
+                res = combine(res, childRec->value);
+            }
+
+            if (auto rec = static_cast<Record *>(record(n))) {
+                rec->value = std::move(res);
+                rec->valid = true;
+            } else {
+                rec = new Record(std::move(res));
+                rec->valid = true;
+                attach(n, rec);
+            }
+        }
+        return static_cast<Record *>(record(node))->value;
+    }
+
+}
+
+#endif // SUBSTATE_AGGREGATE_H
\ No newline at end of file
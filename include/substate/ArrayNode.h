@@ -0,0 +1,573 @@
+// Copyright (C) 2022-2025 Stdware Collections (https://www.github.com/stdware)
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef SUBSTATE_ARRAYNODE_H
+#define SUBSTATE_ARRAYNODE_H
+
+#include <vector>
+#include <cassert>
+#include <cstring>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+
+#include <substate/Node.h>
+#include <substate/Action.h>
+#include <substate/ArrayView.h>
+#include <substate/SharedData.h>
+#include <substate/ContentHash.h>
+
+namespace ss {
+
+    class ArrayActionBase;
+
+    template <class T>
+    class ArrayAction;
+
+    template <class T>
+    class ArrayReplaceAction;
+
+    template <class T>
+    class ArrayTransformAction;
+
+    /// ArrayTransformation - Element-wise transformation of an \c ArrayNode range.
+    /// \note Integers are transformed with wrapping arithmetic, so that overflow is well-defined
+    /// and offsets and odd factors can always be inverted.
+    template <class T>
+    struct ArrayTransformation {
+        static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>,
+                      "T must be a numeric type");
+
+        enum Operation {
+            /// <tt>x * a</tt>
+            Scale,
+            /// <tt>x + a</tt>
+            Offset,
+            /// <tt>min(max(x, a), b)</tt>
+            Clamp,
+        };
+
+        Operation op;
+        T a;
+        T b;
+
+        /// Applies the transformation to \a count elements starting at \a data, the loops are
+        /// branch-free over contiguous memory so that the compiler can vectorize them.
+        inline void apply(T *data, size_t count) const;
+
+        /// Returns whether \c unapply restores the \a count elements starting at \a data exactly
+        /// after \c apply. Unless it holds for any value, it's checked by a round trip over the
+        /// elements, since rounding and overflow may lose information.
+        inline bool isInvertible(const T *data, size_t count) const;
+
+        /// Reverts \c apply, the elements must have passed \c isInvertible.
+        inline void unapply(T *data, size_t count) const;
+
+    protected:
+        template <class U, bool = std::is_integral_v<U>>
+        struct Arithmetic {
+            using type = U;
+        };
+        template <class U>
+        struct Arithmetic<U, true> {
+            using type = std::conditional_t<(sizeof(U) < sizeof(unsigned)), unsigned,
+                                            std::make_unsigned_t<U>>;
+        };
+
+        // Unsigned for integers, which wraps instead of overflowing
+        using W = typename Arithmetic<T>::type;
+
+        static constexpr const bool isInteger = std::is_integral_v<T>;
+    };
+
+    template <class T>
+    inline void ArrayTransformation<T>::apply(T *data, size_t count) const {
+        const T a = this->a;
+        const T b = this->b;
+        switch (op) {
+            case Scale:
+                for (size_t i = 0; i < count; ++i)
+                    data[i] = T(W(data[i]) * W(a));
+                break;
+            case Offset:
+                for (size_t i = 0; i < count; ++i)
+                    data[i] = T(W(data[i]) + W(a));
+                break;
+            case Clamp:
+                for (size_t i = 0; i < count; ++i) {
+                    T x = data[i] < a ? a : data[i];
+                    data[i] = b < x ? b : x;
+                }
+                break;
+        }
+    }
+
+    template <class T>
+    inline bool ArrayTransformation<T>::isInvertible(const T *data, size_t count) const {
+        switch (op) {
+            case Scale:
+                if (a == T(0)) {
+                    return false;
+                }
+                if constexpr (isInteger) {
+                    // An odd factor has an inverse modulo 2^n
+                    if (W(a) & 1) {
+                        return true;
+                    }
+                }
+                break;
+            case Offset:
+                if constexpr (isInteger) {
+                    return true;
+                }
+                break;
+            case Clamp:
+                return false;
+        }
+
+        // Round trip the elements by blocks, comparing the object representations so that the
+        // sign of zero and NaN payloads count
+        constexpr const size_t BlockSize = 256;
+        T block[BlockSize];
+        for (size_t i = 0; i < count; i += BlockSize) {
+            size_t n = std::min(BlockSize, count - i);
+            std::copy(data + i, data + i + n, block);
+            apply(block, n);
+            unapply(block, n);
+            if (std::memcmp(block, data + i, n * sizeof(T)) != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <class T>
+    inline void ArrayTransformation<T>::unapply(T *data, size_t count) const {
+        const T a = this->a;
+        switch (op) {
+            case Scale:
+                if constexpr (isInteger) {
+                    if (W(a) & 1) {
+                        // Newton's iteration doubles the correct low bits from 3 to at least 96
+                        W inverse = W(a);
+                        for (int i = 0; i < 5; ++i)
+                            inverse = W(inverse * W(2 - W(a) * inverse));
+                        for (size_t i = 0; i < count; ++i)
+                            data[i] = T(W(data[i]) * inverse);
+                        break;
+                    }
+                }
+                for (size_t i = 0; i < count; ++i)
+                    data[i] = T(data[i] / a);
+                break;
+            case Offset:
+                for (size_t i = 0; i < count; ++i)
+                    data[i] = T(W(data[i]) - W(a));
+                break;
+            case Clamp:
+                assert(false);
+                break;
+        }
+    }
+
+
+    /// ArrayNodeBase - Non-template part of \c ArrayNode.
+    class SUBSTATE_EXPORT ArrayNodeBase : public Node {
+    public:
+        inline explicit ArrayNodeBase(int type);
+        ~ArrayNodeBase();
+
+    protected:
+        void pushAction(std::unique_ptr<Action> action);
+        void copyIdFrom(const ArrayNodeBase *src, bool copyId);
+
+        friend class ArrayActionBase;
+    };
+
+    inline ArrayNodeBase::ArrayNodeBase(int type) : Node(type) {
+    }
+
+
+    /// ArrayNode - Typed array data structure node, the elements are stored contiguously.
+    /// \tparam T Trivially copyable element type hashable by \c ContentHasher::addObject, the
+    /// transformations require an arithmetic type. \c bool isn't supported since
+    /// <tt>std::vector<bool></tt> doesn't store its elements contiguously.
+    template <class T>
+    class ArrayNode : public ArrayNodeBase {
+        static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+        static_assert(!std::is_same_v<T, bool>, "T must not be bool, use uint8_t instead");
+
+    public:
+        inline explicit ArrayNode(int type = Array);
+        ~ArrayNode() = default;
+
+    public:
+        inline void prepend(std::vector<T> values);
+        inline void append(std::vector<T> values);
+        void insert(int index, std::vector<T> values);
+        void remove(int index, int count);
+        void replace(int index, std::vector<T> values);
+        inline void truncate(int size);
+        inline void clear();
+
+        inline void scale(int index, int count, T factor);
+        inline void offset(int index, int count, T delta);
+        inline void clamp(int index, int count, T min, T max);
+        void transform(int index, int count, const ArrayTransformation<T> &transformation);
+
+        inline ArrayView<T> data() const;
+        inline int count() const;
+        inline int size() const;
+
+    protected:
+        std::shared_ptr<Node> clone(bool copyId) const override;
+        void hashContent(ContentHasher &hasher) const override;
+
+    protected:
+        SharedData<std::vector<T>> _data;
+
+        friend class ArrayAction<T>;
+        friend class ArrayReplaceAction<T>;
+        friend class ArrayTransformAction<T>;
+    };
+
+    template <class T>
+    inline ArrayNode<T>::ArrayNode(int type) : ArrayNodeBase(type) {
+    }
+
+    template <class T>
+    inline void ArrayNode<T>::prepend(std::vector<T> values) {
+        insert(0, std::move(values));
+    }
+
+    template <class T>
+    inline void ArrayNode<T>::append(std::vector<T> values) {
+        insert(size(), std::move(values));
+    }
+
+    template <class T>
+    void ArrayNode<T>::insert(int index, std::vector<T> values) {
+        assert(isWritable());
+        assert(index >= 0 && index <= size() && !values.empty());
+
+        auto a = Action::create<ArrayAction<T>>(
+            actionArena(), Action::ArrayInsert,
+            std::static_pointer_cast<ArrayNode>(shared_from_this()), index, std::move(values));
+        a->execute(false);
+        pushAction(std::move(a));
+    }
+
+    template <class T>
+    void ArrayNode<T>::remove(int index, int count) {
+        assert(isWritable());
+        assert(index >= 0 && count > 0 && count <= size() - index);
+
+        auto begin = _data->begin() + index;
+        auto a = Action::create<ArrayAction<T>>(
+            actionArena(), Action::ArrayRemove,
+            std::static_pointer_cast<ArrayNode>(shared_from_this()), index,
+            std::vector<T>(begin, begin + count));
+        a->execute(false);
+        pushAction(std::move(a));
+    }
+
+    template <class T>
+    void ArrayNode<T>::replace(int index, std::vector<T> values) {
+        assert(isWritable());
+        assert(index >= 0 && index <= size() && !values.empty());
+
+        // Grow the array first if the values run past the end
+        if (int off = index + int(values.size()) - size(); off > 0) {
+            insert(size(), std::vector<T>(off, T()));
+        }
+
+        auto begin = _data->begin() + index;
+        std::vector<T> oldValues(begin, begin + values.size());
+        auto a = Action::create<ArrayReplaceAction<T>>(
+            actionArena(), std::static_pointer_cast<ArrayNode>(shared_from_this()), index,
+            std::move(values), std::move(oldValues));
+        a->execute(false);
+        pushAction(std::move(a));
+    }
+
+    template <class T>
+    inline void ArrayNode<T>::truncate(int size) {
+        remove(size, this->size() - size);
+    }
+
+    template <class T>
+    inline void ArrayNode<T>::clear() {
+        remove(0, size());
+    }
+
+    template <class T>
+    inline void ArrayNode<T>::scale(int index, int count, T factor) {
+        transform(index, count, {ArrayTransformation<T>::Scale, factor, T()});
+    }
+
+    template <class T>
+    inline void ArrayNode<T>::offset(int index, int count, T delta) {
+        transform(index, count, {ArrayTransformation<T>::Offset, delta, T()});
+    }
+
+    template <class T>
+    inline void ArrayNode<T>::clamp(int index, int count, T min, T max) {
+        assert(!(max < min));
+        transform(index, count, {ArrayTransformation<T>::Clamp, min, max});
+    }
+
+    template <class T>
+    void ArrayNode<T>::transform(int index, int count,
+                                 const ArrayTransformation<T> &transformation) {
+        static_assert(std::is_arithmetic_v<T>, "T must be an arithmetic type");
+        assert(isWritable());
+        assert(index >= 0 && count > 0 && count <= size() - index);
+
+        // Keep the old values only if undo can't recompute them
+        std::vector<T> oldValues;
+        auto begin = _data->data() + index;
+        if (!transformation.isInvertible(begin, count)) {
+            oldValues.assign(begin, begin + count);
+        }
+        auto a = Action::create<ArrayTransformAction<T>>(
+            actionArena(), std::static_pointer_cast<ArrayNode>(shared_from_this()), index, count,
+            transformation, std::move(oldValues));
+        a->execute(false);
+        pushAction(std::move(a));
+    }
+
+    template <class T>
+    inline ArrayView<T> ArrayNode<T>::data() const {
+        return *_data;
+    }
+
+    template <class T>
+    inline int ArrayNode<T>::count() const {
+        return size();
+    }
+
+    template <class T>
+    inline int ArrayNode<T>::size() const {
+        return int(_data->size());
+    }
+
+    template <class T>
+    std::shared_ptr<Node> ArrayNode<T>::clone(bool copyId) const {
+        auto node = std::make_shared<ArrayNode>(_type);
+        node->copyIdFrom(this, copyId);
+        node->_data = _data; // Shared until either node is changed
+        return node;
+    }
+
+    template <class T>
+    void ArrayNode<T>::hashContent(ContentHasher &hasher) const {
+        hasher.add(uint64_t(_data->size()));
+        if constexpr (std::is_arithmetic_v<T> || std::has_unique_object_representations_v<T>) {
+            hasher.write(_data->data(), _data->size() * sizeof(T));
+        } else {
+            for (const auto &item : std::as_const(*_data)) {
+                hasher.addObject(item);
+            }
+        }
+    }
+
+
+    /// ArrayActionBase - Base action for \c ArrayNode operations.
+    class SUBSTATE_EXPORT ArrayActionBase : public NodeAction {
+    public:
+        inline ArrayActionBase(Type type, const std::shared_ptr<ArrayNodeBase> &parent, int index);
+        ~ArrayActionBase() = default;
+
+    public:
+        inline int index() const;
+
+    public:
+        void queryNodes(bool inserted,
+                        const std::function<void(const std::shared_ptr<Node> &)> &add) override;
+
+    protected:
+        /// Begins the change and sends the pre-notification.
+        void beginChange(bool undo);
+
+        /// Sends the notification and ends the change.
+        void endChange(bool undo);
+
+        int _index;
+    };
+
+    inline ArrayActionBase::ArrayActionBase(Type type, const std::shared_ptr<ArrayNodeBase> &parent,
+                                            int index)
+        : NodeAction(type, parent), _index(index) {
+    }
+
+    inline int ArrayActionBase::index() const {
+        return _index;
+    }
+
+
+    /// ArrayAction - Action for \c ArrayNode insertion or deletion.
+    template <class T>
+    class ArrayAction : public ArrayActionBase {
+    public:
+        inline ArrayAction(Type type, const std::shared_ptr<ArrayNode<T>> &parent, int index,
+                           std::vector<T> values);
+        ~ArrayAction() = default;
+
+    public:
+        inline ArrayView<T> values() const;
+
+    public:
+        void execute(bool undo) override;
+
+    protected:
+        std::vector<T> _values;
+    };
+
+    template <class T>
+    inline ArrayAction<T>::ArrayAction(Type type, const std::shared_ptr<ArrayNode<T>> &parent,
+                                       int index, std::vector<T> values)
+        : ArrayActionBase(type, parent, index), _values(std::move(values)) {
+    }
+
+    template <class T>
+    inline ArrayView<T> ArrayAction<T>::values() const {
+        return _values;
+    }
+
+    template <class T>
+    void ArrayAction<T>::execute(bool undo) {
+        auto &data = static_cast<ArrayNode<T> *>(_parent.get())->_data.detach();
+
+        beginChange(undo);
+
+        // Do change
+        if ((_type == ArrayRemove) ^ undo) {
+            auto begin = data.begin() + _index;
+            data.erase(begin, begin + _values.size());
+        } else {
+            data.insert(data.begin() + _index, _values.begin(), _values.end());
+        }
+
+        endChange(undo);
+    }
+
+
+    /// ArrayReplaceAction - Action for \c ArrayNode replacement.
+    template <class T>
+    class ArrayReplaceAction : public ArrayAction<T> {
+    public:
+        inline ArrayReplaceAction(const std::shared_ptr<ArrayNode<T>> &parent, int index,
+                                  std::vector<T> values, std::vector<T> oldValues);
+        ~ArrayReplaceAction() = default;
+
+    public:
+        inline ArrayView<T> oldValues() const;
+
+    public:
+        void execute(bool undo) override;
+
+    protected:
+        std::vector<T> _oldValues;
+    };
+
+    template <class T>
+    inline ArrayReplaceAction<T>::ArrayReplaceAction(const std::shared_ptr<ArrayNode<T>> &parent,
+                                                     int index, std::vector<T> values,
+                                                     std::vector<T> oldValues)
+        : ArrayAction<T>(Action::ArrayReplace, parent, index, std::move(values)),
+          _oldValues(std::move(oldValues)) {
+    }
+
+    template <class T>
+    inline ArrayView<T> ArrayReplaceAction<T>::oldValues() const {
+        return _oldValues;
+    }
+
+    template <class T>
+    void ArrayReplaceAction<T>::execute(bool undo) {
+        auto &data = static_cast<ArrayNode<T> *>(this->_parent.get())->_data.detach();
+
+        this->beginChange(undo);
+
+        // Do change
+        const auto &values = undo ? _oldValues : this->_values;
+        std::copy(values.begin(), values.end(), data.begin() + this->_index);
+
+        this->endChange(undo);
+    }
+
+
+    /// ArrayTransformAction - Action for \c ArrayNode transformation.
+    /// \note The action only keeps the transformation if undo can invert it exactly, which holds
+    /// for integer offsets and odd integer factors, and for other factors and floating-point
+    /// operations whose round trip over the old values is exact. Otherwise, such as for a clamp,
+    /// it keeps the old values, which costs O(count) memory like a replacement.
+    template <class T>
+    class ArrayTransformAction : public ArrayActionBase {
+    public:
+        inline ArrayTransformAction(const std::shared_ptr<ArrayNode<T>> &parent, int index,
+                                    int count, const ArrayTransformation<T> &transformation,
+                                    std::vector<T> oldValues);
+        ~ArrayTransformAction() = default;
+
+    public:
+        inline int count() const;
+        inline const ArrayTransformation<T> &transformation() const;
+
+        /// Returns the old values, empty if undo inverts the transformation instead.
+        inline ArrayView<T> oldValues() const;
+
+    public:
+        void execute(bool undo) override;
+
+    protected:
+        ArrayTransformation<T> _transformation;
+        int _count;
+        std::vector<T> _oldValues;
+    };
+
+    template <class T>
+    inline ArrayTransformAction<T>::ArrayTransformAction(
+        const std::shared_ptr<ArrayNode<T>> &parent, int index, int count,
+        const ArrayTransformation<T> &transformation, std::vector<T> oldValues)
+        : ArrayActionBase(ArrayTransform, parent, index), _transformation(transformation),
+          _count(count), _oldValues(std::move(oldValues)) {
+        assert(_oldValues.empty() || int(_oldValues.size()) == count);
+    }
+
+    template <class T>
+    inline int ArrayTransformAction<T>::count() const {
+        return _count;
+    }
+
+    template <class T>
+    inline const ArrayTransformation<T> &ArrayTransformAction<T>::transformation() const {
+        return _transformation;
+    }
+
+    template <class T>
+    inline ArrayView<T> ArrayTransformAction<T>::oldValues() const {
+        return _oldValues;
+    }
+
+    template <class T>
+    void ArrayTransformAction<T>::execute(bool undo) {
+        auto &data = static_cast<ArrayNode<T> *>(_parent.get())->_data.detach();
+
+        beginChange(undo);
+
+        // Do change
+        if (!undo) {
+            _transformation.apply(data.data() + _index, _count);
+        } else if (_oldValues.empty()) {
+            _transformation.unapply(data.data() + _index, _count);
+        } else {
+            std::copy(_oldValues.begin(), _oldValues.end(), data.begin() + _index);
+        }
+
+        endChange(undo);
+    }
+
+}
+
+#endif // SUBSTATE_ARRAYNODE_H
\ No newline at end of file
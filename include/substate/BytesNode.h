@@ -9,8 +9,7 @@
 #include <substate/Node.h>
 #include <substate/Action.h>
 #include <substate/ArrayView.h>
-
-#include <qsubstate/qsubstate_global.h>
+#include <substate/SharedData.h>
 
 namespace ss {
 
@@ -40,9 +39,10 @@ namespace ss {
 
     protected:
         std::shared_ptr<Node> clone(bool copyId) const override;
+        void hashContent(ContentHasher &hasher) const override;
 
     protected:
-        std::vector<char> _data;
+        SharedData<std::vector<char>> _data;
 
         friend class BytesNodePrivate;
         friend class BytesAction;
@@ -69,14 +69,14 @@ namespace ss {
     }
 
     inline ArrayView<char> BytesNode::data() const {
-        return _data;
+        return *_data;
     }
 
     inline int BytesNode::size() const {
-        return int(_data.size());
+        return int(_data->size());
     }
 
-    int BytesNode::count() const {
+    inline int BytesNode::count() const {
         return size();
     }
 
@@ -0,0 +1,149 @@
+// Copyright (C) 2022-2025 Stdware Collections (https://www.github.com/stdware)
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef SUBSTATE_CONTENTHASH_H
+#define SUBSTATE_CONTENTHASH_H
+
+#include <string>
+#include <cstdint>
+#include <utility>
+#include <string_view>
+#include <type_traits>
+
+#include <substate/Aggregate.h>
+
+namespace ss {
+
+    class Value;
+
+    /// Hash128 - 128-bit content hash.
+    struct Hash128 {
+        uint64_t low = 0;
+        uint64_t high = 0;
+
+        inline bool operator==(const Hash128 &other) const;
+        inline bool operator!=(const Hash128 &other) const;
+    };
+
+    inline bool Hash128::operator==(const Hash128 &other) const {
+        return low == other.low && high == other.high;
+    }
+
+    inline bool Hash128::operator!=(const Hash128 &other) const {
+        return !(*this == other);
+    }
+
+
+    /// ContentHasher - Streaming 128-bit hash, fed by \c Node::hashContent.
+    /// \note The input is consumed in 64-bit words by two multiply-mix lanes, the result doesn't
+    /// depend on how the input is split into writes. It's fast but not cryptographic.
+    class SUBSTATE_EXPORT ContentHasher {
+    public:
+        ContentHasher() = default;
+
+    public:
+        void write(const void *data, size_t size);
+
+        /// Adds an arithmetic or enumeration value.
+        template <class T>
+        inline void add(T value);
+
+        /// Adds a string prefixed by its length, so that adjacent strings can't be confused.
+        inline void add(std::string_view s);
+        inline void add(const std::string &s);
+        inline void add(const char *s);
+
+        /// Adds a value, a node value only adds its type since the children are hashed apart.
+        void add(const Value &value);
+
+        /// Adds an object of any hashable type \a T: a type taken by \c add, a type whose object
+        /// representation is its value, or a type with a <tt>hashValue(ContentHasher &, const T
+        /// &)</tt> overload found by argument-dependent lookup, which takes precedence.
+        /// \note Floating-point values are hashed by representation, so \c 0.0 and \c -0.0
+        /// differ.
+        template <class T>
+        inline void addObject(const T &value);
+
+        Hash128 finish() const;
+
+    protected:
+        template <class T, class = void>
+        struct HasHashValue : std::false_type {};
+        template <class T>
+        struct HasHashValue<T, std::void_t<decltype(hashValue(std::declval<ContentHasher &>(),
+                                                              std::declval<const T &>()))>>
+            : std::true_type {};
+
+        void consume(uint64_t word);
+
+        uint64_t _a = 0x243f6a8885a308d3;
+        uint64_t _b = 0x13198a2e03707344;
+        uint64_t _tail = 0; // Bytes of the incomplete word
+        uint64_t _length = 0;
+    };
+
+    template <class T>
+    inline void ContentHasher::add(T value) {
+        static_assert(std::is_arithmetic_v<T> || std::is_enum_v<T>, "unsupported type");
+        write(&value, sizeof(T));
+    }
+
+    inline void ContentHasher::add(std::string_view s) {
+        add(uint64_t(s.size()));
+        write(s.data(), s.size());
+    }
+
+    inline void ContentHasher::add(const std::string &s) {
+        add(std::string_view(s));
+    }
+
+    inline void ContentHasher::add(const char *s) {
+        add(std::string_view(s));
+    }
+
+    template <class T>
+    inline void ContentHasher::addObject(const T &value) {
+        if constexpr (HasHashValue<T>::value) {
+            hashValue(*this, value);
+        } else if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T>) {
+            add(value);
+        } else if constexpr (std::is_convertible_v<const T &, std::string_view>) {
+            add(std::string_view(value));
+        } else if constexpr (std::is_same_v<T, Value>) {
+            add(value);
+        } else {
+            // Padding bytes would make equal objects hash differently
+            static_assert(std::has_unique_object_representations_v<T>,
+                          "T needs a hashValue(ContentHasher &, const T &) overload");
+            write(&value, sizeof(T));
+        }
+    }
+
+
+    /// ContentHash - Merkle hash of every subtree of a model.
+    /// \note The hash of a node covers its type, its own content and the hashes of its children
+    /// in order, so equal subtrees have equal hashes and a subtree whose hash is unchanged can be
+    /// skipped by an incremental export. The hashes are cached and dropped along the ancestor
+    /// path by every action, comparing them is O(1) until the next change. The keys of dict and
+    /// mapping nodes are ordered by interning, so their hashes should only be compared within a
+    /// process.
+    class SUBSTATE_EXPORT ContentHash : public Aggregate<Hash128> {
+    public:
+        explicit ContentHash(Model *model);
+        ~ContentHash();
+
+    public:
+        Hash128 local(const Node *node) const override;
+        Hash128 combine(const Hash128 &a, const Hash128 &b) const override;
+
+        /// Returns whether the subtrees of \a a and \a b have the same content.
+        inline bool equals(const Node *a, const Node *b);
+    };
+
+    inline bool ContentHash::equals(const Node *a, const Node *b) {
+        return value(a) == value(b);
+    }
+
+}
+
+#endif // SUBSTATE_CONTENTHASH_H
\ No newline at end of file
@@ -0,0 +1,128 @@
+// Copyright (C) 2022-2025 Stdware Collections (https://www.github.com/stdware)
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef SUBSTATE_DICTNODE_H
+#define SUBSTATE_DICTNODE_H
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+#include <substate/ArrayView.h>
+#include <substate/Value.h>
+
+namespace ss {
+
+    class DictAction;
+
+    class DictNodePrivate;
+
+    /// DictNode - Key-value data structure node, the Qt-free counterpart of \c MappingNode.
+    /// \note The entries are stored in a flat array sorted by the id of the interned key, so the
+    /// iteration order follows the order in which the keys were first interned, which may differ
+    /// between processes. Reading by name never interns it, assigning by name does.
+    class SUBSTATE_EXPORT DictNode : public Node {
+    public:
+        using Entry = std::pair<ValueKey, Value>;
+
+        inline explicit DictNode(int type = Dict);
+        ~DictNode();
+
+    public:
+        inline Value value(const ValueKey &key) const;
+        inline Value value(const std::string &name) const;
+        bool setValue(const ValueKey &key, const Value &value);
+        inline bool setValue(const std::string &name, const Value &value);
+        inline ArrayView<Entry> data() const;
+        inline int count() const;
+        inline int size() const;
+
+    protected:
+        std::shared_ptr<Node> clone(bool copyId) const override;
+        void collectChildren(std::vector<Node *> &children) const override;
+        void hashContent(ContentHasher &hasher) const override;
+
+        inline std::vector<Entry>::const_iterator lowerBound(const ValueKey &key) const;
+        void assign(const ValueKey &key, const Value &value);
+
+        std::vector<Entry> _entries;
+
+        friend class DictNodePrivate;
+        friend class DictAction;
+    };
+
+    inline DictNode::DictNode(int type) : Node(type) {
+    }
+
+    inline Value DictNode::value(const ValueKey &key) const {
+        auto it = lowerBound(key);
+        if (it == _entries.end() || it->first != key) {
+            return {};
+        }
+        return it->second;
+    }
+
+    inline Value DictNode::value(const std::string &name) const {
+        auto key = ValueKey::find(name);
+        if (!key.isValid()) {
+            return {};
+        }
+        return value(key);
+    }
+
+    inline bool DictNode::setValue(const std::string &name, const Value &value) {
+        // Removing a name that has never been interned changes nothing
+        auto key = value.isValid() ? ValueKey(name) : ValueKey::find(name);
+        return key.isValid() && setValue(key, value);
+    }
+
+    inline ArrayView<DictNode::Entry> DictNode::data() const {
+        return _entries;
+    }
+
+    inline int DictNode::count() const {
+        return int(_entries.size());
+    }
+
+    inline int DictNode::size() const {
+        return int(_entries.size());
+    }
+
+    inline std::vector<DictNode::Entry>::const_iterator
+        DictNode::lowerBound(const ValueKey &key) const {
+        return std::lower_bound(_entries.begin(), _entries.end(), key,
+                                [](const Entry &entry, const ValueKey &key) {
+                                    return entry.first < key; //
+                                });
+    }
+
+
+    /// DictAction - Action for \c DictNode operations.
+    class SUBSTATE_EXPORT DictAction : public ValueAction {
+    public:
+        inline DictAction(const std::shared_ptr<DictNode> &parent, const ValueKey &key,
+                          Value oldValue, Value value);
+        ~DictAction();
+
+    public:
+        void execute(bool undo) override;
+
+    public:
+        inline ValueKey key() const;
+
+    protected:
+        ValueKey _key;
+    };
+
+    inline DictAction::DictAction(const std::shared_ptr<DictNode> &parent, const ValueKey &key,
+                                  Value oldValue, Value value)
+        : ValueAction(DictAssign, parent, std::move(oldValue), std::move(value)), _key(key) {
+    }
+
+    inline ValueKey DictAction::key() const {
+        return _key;
+    }
+
+}
+
+#endif // SUBSTATE_DICTNODE_H
\ No newline at end of file
@@ -0,0 +1,127 @@
+// Copyright (C) 2022-2025 Stdware Collections (https://www.github.com/stdware)
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef SUBSTATE_IDTABLE_H
+#define SUBSTATE_IDTABLE_H
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+
+#include <substate/substate_global.h>
+
+namespace ss {
+
+    class Node;
+
+    /// IdTable - Table of nodes indexed by id, stored in pages of fixed-size slot arrays.
+    /// \note Ids are allocated in ascending order, so the occupied slots are dense and a lookup is
+    /// two array accesses. A page is released once its last slot is cleared.
+    class SUBSTATE_EXPORT IdTable {
+    public:
+        IdTable() = default;
+        ~IdTable();
+
+        IdTable(const IdTable &) = delete;
+        IdTable &operator=(const IdTable &) = delete;
+
+        IdTable(IdTable &&) = default;
+        IdTable &operator=(IdTable &&) = default;
+
+    public:
+        /// Returns the node of \a id, or null if there's none.
+        inline Node *find(size_t id) const;
+
+        /// Sets the node of \a id, does nothing if the slot is already occupied.
+        inline void insert(size_t id, Node *node);
+
+        inline void erase(size_t id);
+        void clear();
+
+        /// Clears the slot of \a id but keeps the pages, the table must be cleared afterwards.
+        inline void drop(size_t id);
+        inline size_t size() const;
+
+        /// Calls \a func with the id and the node of each occupied slot in ascending order.
+        template <class Func>
+        void forEach(Func &&func) const;
+
+    protected:
+        static constexpr const size_t PageBits = 12;
+        static constexpr const size_t PageSize = size_t(1) << PageBits;
+
+        struct Page {
+            std::unique_ptr<Node *[]> slots;
+            size_t count = 0;
+        };
+
+        Page &page(size_t index);
+        void releasePage(size_t index);
+
+        std::vector<Page> _pages;
+        size_t _size = 0;
+    };
+
+    inline Node *IdTable::find(size_t id) const {
+        size_t index = id >> PageBits;
+        if (index >= _pages.size() || !_pages[index].slots) {
+            return nullptr;
+        }
+        return _pages[index].slots[id & (PageSize - 1)];
+    }
+
+    inline void IdTable::insert(size_t id, Node *node) {
+        auto &page = this->page(id >> PageBits);
+        auto &slot = page.slots[id & (PageSize - 1)];
+        if (slot) {
+            return;
+        }
+        slot = node;
+        page.count++;
+        _size++;
+    }
+
+    inline void IdTable::erase(size_t id) {
+        size_t index = id >> PageBits;
+        if (index >= _pages.size() || !_pages[index].slots) {
+            return;
+        }
+        auto &page = _pages[index];
+        auto &slot = page.slots[id & (PageSize - 1)];
+        if (!slot) {
+            return;
+        }
+        slot = nullptr;
+        _size--;
+        if (--page.count == 0) {
+            releasePage(index);
+        }
+    }
+
+    inline void IdTable::drop(size_t id) {
+        _pages[id >> PageBits].slots[id & (PageSize - 1)] = nullptr;
+        _size--;
+    }
+
+    inline size_t IdTable::size() const {
+        return _size;
+    }
+
+    template <class Func>
+    void IdTable::forEach(Func &&func) const {
+        for (size_t i = 0; i < _pages.size(); ++i) {
+            const auto &page = _pages[i];
+            if (!page.slots) {
+                continue;
+            }
+            for (size_t j = 0; j < PageSize; ++j) {
+                if (auto node = page.slots[j]) {
+                    func((i << PageBits) | j, node);
+                }
+            }
+        }
+    }
+
+}
+
+#endif // SUBSTATE_IDTABLE_H
\ No newline at end of file
@@ -0,0 +1,83 @@
+// Copyright (C) 2022-2025 Stdware Collections (https://www.github.com/stdware)
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef SUBSTATE_KEYTABLE_H
+#define SUBSTATE_KEYTABLE_H
+
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <functional>
+#include <unordered_map>
+
+namespace ss {
+
+    /// KeyTable - Thread-safe table interning keys into dense integer ids starting from 0.
+    /// \note An interned key is never removed, so its id and the reference returned by \c key()
+    /// stay valid for the lifetime of the table. Lookups share the lock, only interning a new key
+    /// takes it exclusively.
+    template <class K, class Hash = std::hash<K>>
+    class KeyTable {
+    public:
+        KeyTable() = default;
+
+        KeyTable(const KeyTable &) = delete;
+        KeyTable &operator=(const KeyTable &) = delete;
+
+    public:
+        /// Returns the id of \a key, interns it first if it's unknown.
+        inline int intern(const K &key);
+
+        /// Returns the id of \a key, or -1 if it's not interned.
+        inline int find(const K &key) const;
+
+        inline const K &key(int id) const;
+        inline int size() const;
+
+    protected:
+        mutable std::shared_mutex _mutex;
+        std::unordered_map<K, int, Hash> _ids;
+        std::deque<K> _keys; // Never reallocates the stored keys
+    };
+
+    template <class K, class Hash>
+    inline int KeyTable<K, Hash>::intern(const K &key) {
+        // Most keys are known already, look them up without blocking the other readers
+        int id = find(key);
+        if (id >= 0) {
+            return id;
+        }
+
+        std::unique_lock<std::shared_mutex> lock(_mutex);
+        auto it = _ids.find(key);
+        if (it != _ids.end()) {
+            return it->second;
+        }
+        id = int(_keys.size());
+        _ids.emplace(key, id);
+        _keys.push_back(key);
+        return id;
+    }
+
+    template <class K, class Hash>
+    inline int KeyTable<K, Hash>::find(const K &key) const {
+        std::shared_lock<std::shared_mutex> lock(_mutex);
+        auto it = _ids.find(key);
+        return it == _ids.end() ? -1 : it->second;
+    }
+
+    template <class K, class Hash>
+    inline const K &KeyTable<K, Hash>::key(int id) const {
+        std::shared_lock<std::shared_mutex> lock(_mutex);
+        return _keys.at(id);
+    }
+
+    template <class K, class Hash>
+    inline int KeyTable<K, Hash>::size() const {
+        std::shared_lock<std::shared_mutex> lock(_mutex);
+        return int(_keys.size());
+    }
+
+}
+
+#endif // SUBSTATE_KEYTABLE_H
\ No newline at end of file
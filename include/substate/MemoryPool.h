@@ -0,0 +1,209 @@
+// Copyright (C) 2022-2025 Stdware Collections (https://www.github.com/stdware)
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef SUBSTATE_MEMORYPOOL_H
+#define SUBSTATE_MEMORYPOOL_H
+
+#include <new>
+#include <vector>
+#include <cstddef>
+
+#include <substate/substate_global.h>
+
+namespace ss {
+
+    /// MemoryPool - Size-class pools carved from large chunks.
+    /// \note Freed blocks are kept in per-class free lists and reused, the chunks are returned to
+    /// the system when the pool is destroyed. The pool is not thread-safe, so it's reference
+    /// counted without atomic operations and deletes itself when the last reference is dropped.
+    class SUBSTATE_EXPORT MemoryPool {
+    public:
+        MemoryPool() = default;
+        ~MemoryPool();
+
+        MemoryPool(const MemoryPool &) = delete;
+        MemoryPool &operator=(const MemoryPool &) = delete;
+
+    public:
+        static constexpr const size_t Alignment = 16;
+        static constexpr const size_t MaxPooledSize = 512;
+
+        /// Allocates \a size bytes, blocks larger than \c MaxPooledSize go to the global heap.
+        inline void *allocate(size_t size);
+        inline void deallocate(void *ptr, size_t size);
+
+        /// Returns the size of all chunks reserved by the pool.
+        inline size_t reservedSize() const;
+
+        inline void ref();
+        inline void deref();
+
+    protected:
+        static constexpr const size_t ChunkSize = 64 * 1024;
+
+        struct FreeBlock {
+            FreeBlock *next;
+        };
+
+        void *allocateBlock(size_t index);
+
+        FreeBlock *_free[MaxPooledSize / Alignment] = {};
+        std::vector<void *> _chunks;
+        char *_cursor = nullptr;
+        char *_end = nullptr;
+        size_t _refs = 0;
+    };
+
+    inline void *MemoryPool::allocate(size_t size) {
+        if (size > MaxPooledSize) {
+            return ::operator new(size);
+        }
+        size_t index = size ? (size - 1) / Alignment : 0;
+        if (auto block = _free[index]) {
+            _free[index] = block->next;
+            return block;
+        }
+        return allocateBlock(index);
+    }
+
+    inline void MemoryPool::deallocate(void *ptr, size_t size) {
+        if (size > MaxPooledSize) {
+            ::operator delete(ptr);
+            return;
+        }
+        size_t index = size ? (size - 1) / Alignment : 0;
+        auto block = static_cast<FreeBlock *>(ptr);
+        block->next = _free[index];
+        _free[index] = block;
+    }
+
+    inline size_t MemoryPool::reservedSize() const {
+        return _chunks.size() * ChunkSize;
+    }
+
+    inline void MemoryPool::ref() {
+        _refs++;
+    }
+
+    inline void MemoryPool::deref() {
+        if (--_refs == 0) {
+            delete this;
+        }
+    }
+
+
+    /// PoolAllocator - Allocator over a shared memory pool, for use with \c std::allocate_shared.
+    /// \note The allocator holds a reference of the pool, so the pool lives as long as any object
+    /// allocated from it.
+    template <class T>
+    class PoolAllocator {
+    public:
+        using value_type = T;
+
+        static_assert(alignof(T) <= MemoryPool::Alignment, "over-aligned type");
+
+        inline explicit PoolAllocator(MemoryPool *pool) noexcept : _pool(pool) {
+            _pool->ref();
+        }
+
+        inline PoolAllocator(const PoolAllocator &other) noexcept : _pool(other._pool) {
+            _pool->ref();
+        }
+
+        template <class U>
+        inline PoolAllocator(const PoolAllocator<U> &other) noexcept : _pool(other._pool) {
+            _pool->ref();
+        }
+
+        inline PoolAllocator &operator=(const PoolAllocator &other) noexcept {
+            other._pool->ref();
+            _pool->deref();
+            _pool = other._pool;
+            return *this;
+        }
+
+        inline ~PoolAllocator() {
+            _pool->deref();
+        }
+
+        inline T *allocate(size_t n) {
+            return static_cast<T *>(_pool->allocate(n * sizeof(T)));
+        }
+
+        inline void deallocate(T *ptr, size_t n) noexcept {
+            _pool->deallocate(ptr, n * sizeof(T));
+        }
+
+        template <class U>
+        inline bool operator==(const PoolAllocator<U> &other) const noexcept {
+            return _pool == other._pool;
+        }
+
+        template <class U>
+        inline bool operator!=(const PoolAllocator<U> &other) const noexcept {
+            return _pool != other._pool;
+        }
+
+    protected:
+        MemoryPool *_pool;
+
+        template <class U>
+        friend class PoolAllocator;
+    };
+
+
+    /// ActionArena - Bump arena holding the actions of one transaction.
+    /// \note Actions outlive their transaction in the undo stack, so the arena counts its live
+    /// allocations and frees itself when the last one is released after it's been detached from
+    /// the model. The arena is not thread-safe.
+    class SUBSTATE_EXPORT ActionArena {
+    public:
+        ActionArena() = default;
+        ~ActionArena();
+
+        ActionArena(const ActionArena &) = delete;
+        ActionArena &operator=(const ActionArena &) = delete;
+
+    public:
+        void *allocate(size_t size);
+        inline void release();
+
+        /// Drops the blocks after the first one, the arena must hold no live allocation.
+        void rewind();
+
+        /// Called by the model when the transaction is committed, the arena is deleted once it
+        /// holds no live allocation.
+        inline void detach();
+
+    protected:
+        static constexpr const size_t MinBlockSize = 1024;
+        static constexpr const size_t MaxBlockSize = 64 * 1024;
+
+        struct Block {
+            Block *next;
+            size_t size;
+        };
+
+        Block *_blocks = nullptr;
+        char *_cursor = nullptr;
+        char *_end = nullptr;
+        size_t _count = 0;
+        bool _detached = false;
+    };
+
+    inline void ActionArena::release() {
+        if (--_count == 0 && _detached) {
+            delete this;
+        }
+    }
+
+    inline void ActionArena::detach() {
+        _detached = true;
+        if (_count == 0) {
+            delete this;
+        }
+    }
+
+}
+
+#endif // SUBSTATE_MEMORYPOOL_H
\ No newline at end of file
@@ -12,6 +12,7 @@
 #include <substate/Notification.h>
 #include <substate/Node.h>
 #include <substate/Action.h>
+#include <substate/MemoryPool.h>
 
 namespace ss {
 
@@ -21,6 +22,8 @@ namespace ss {
 
     class ModelPrivate;
 
+    class AggregateBase;
+
     /// Model - Document model and undo/redo manager.
     class SUBSTATE_EXPORT Model : public NotificationSubject {
     public:
@@ -58,11 +61,23 @@ namespace ss {
 
         /// Return the node of \a id.
         std::shared_ptr<Node> indexOf(size_t id) const;
+        Node *find(size_t id) const;
 
         inline std::shared_ptr<Node> root() const;
         void setRoot(const std::shared_ptr<Node> &root);
 
+        /// Creates a node of type \a T in the memory pool of the model.
+        /// \note The pool is not thread-safe, the node should be released in the model's thread.
+        template <class T, class... Args>
+        inline std::shared_ptr<T> create(Args &&...args) const;
+
+        inline MemoryPool *memoryPool() const;
+
         /// Reset the model to empty state.
+        /// \note Nodes still referenced from outside survive as free nodes. The memory pool keeps
+        /// the released blocks for the next document.
+        /// \note Every node and action is still destroyed one at a time, only the id table is
+        /// dropped in whole, so the cost grows linearly with the document and its history.
         void reset();
 
         /// Enters the transaction state.
@@ -85,24 +100,38 @@ namespace ss {
     protected:
         void notify(Notification *n) override;
 
-        Node *_lockedNode;
+        Node *_lockedNode = nullptr;
         std::shared_ptr<Node> _root;
         State _state = Idle;
         std::vector<std::unique_ptr<Action>> _txActions;
         std::unique_ptr<StorageEngine> _storageEngine;
+        MemoryPool *_pool;
+        ActionArena *_arena = nullptr;
         bool _clearing = false;
+        size_t _structureEpoch = 1; // Bumped when the root or a large subtree is moved
+        std::vector<AggregateBase *> _aggregates;
 
         friend class Node;
         friend class NodePrivate;
         friend class ModelPrivate;
         friend class StorageEngine;
         friend class StandardStorageEngine;
+        friend class AggregateBase;
     };
 
     inline StorageEngine *Model::storageEngine() const {
         return _storageEngine.get();
     }
 
+    template <class T, class... Args>
+    inline std::shared_ptr<T> Model::create(Args &&...args) const {
+        return std::allocate_shared<T>(PoolAllocator<T>(_pool), std::forward<Args>(args)...);
+    }
+
+    inline MemoryPool *Model::memoryPool() const {
+        return _pool;
+    }
+
     inline Model::State Model::state() const {
         return _state;
     }
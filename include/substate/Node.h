@@ -4,7 +4,10 @@
 #ifndef SUBSTATE_NODE_H
 #define SUBSTATE_NODE_H
 
+#include <atomic>
+#include <vector>
 #include <memory>
+#include <algorithm>
 #include <functional>
 #include <iostream>
 
@@ -18,9 +21,17 @@ namespace ss {
 
     class NodePrivate;
 
+    class ActionArena;
+
+    class AggregateBase;
+
+    class AggregateRecord;
+
+    class ContentHasher;
+
     /// Node - Document information storage unit.
-    /// \note The node should be created by \c std::make_shared instead of created by direct
-    /// construction.
+    /// \note The node should be created by \c std::make_shared or \c Model::create instead of
+    /// created by direct construction.
     class SUBSTATE_EXPORT Node : public NotificationSubject,
                                  public std::enable_shared_from_this<Node> {
     public:
@@ -32,6 +43,13 @@ namespace ss {
             Vector,
             Sheet,
             Mapping,
+            Timeline,
+            Dict,
+            Record,
+            Array,
+            Text,
+            SparseVector,
+            Sorted,
             User = 1024,
         };
 
@@ -48,31 +66,65 @@ namespace ss {
         inline State state() const;
         inline size_t id() const;
         inline std::shared_ptr<Node> parent() const;
+        /// Returns the parent without touching its reference count, valid while the parent is
+        /// alive. Every accessor returning a raw \c Node pointer, like \c nodeAt or
+        /// \c Model::find, and every \c NodeView borrows the same way.
+        inline Node *parentNode() const;
         inline Model *model() const;
 
         inline bool isFree() const;
+
+        /// Returns whether the node or one of its ancestors is removed.
+        /// \note Like \c isWritable, it may be called from several threads at once as long as the
+        /// model isn't changed meanwhile.
         bool isDetached() const;
         bool isWritable() const;
 
         /// Clone the node without copying its id.
+        /// \note Byte, array and text payloads are shared with the source until either side writes
+        /// them, but every node of the subtree is still cloned one by one, so cloning a container
+        /// costs time and memory linear in its number of descendants. Neither cloning nor
+        /// destroying a deep tree recurses along its depth.
         inline std::shared_ptr<Node> clone() const;
 
+        /// Clone the node without copying its id, the children of wide \c VectorNode and
+        /// \c SheetNode containers are cloned on \a threads threads, all cores if it's 0.
+        /// \note The \c clone of every node type in the subtree must be safe to run concurrently.
+        std::shared_ptr<Node> parallelClone(int threads = 0) const;
+
         /// Execute \a func on this node and all its children.
         inline void propagate(const std::function<void(Node *)> &func);
 
+        /// Calls \a func on this node and all its descendants in pre-order.
+        /// \note The tree is walked with an explicit stack and \a func is called directly, so deep
+        /// trees can't overflow the call stack and no call is type-erased.
+        template <class Func>
+        void traverse(Func &&func);
+
     protected:
         void beginAction();
         void endAction();
 
+        /// Returns the action arena of the model's current transaction, or null if there's none.
+        ActionArena *actionArena() const;
+
         void addChild(Node *child);
         void removeChild(Node *child);
 
         /// Clone the node with option(s).
-        /// \param copyId The id of the cloned node = \a copyId ? 0 : this->id().
+        /// \param copyId The id of the cloned node = \a copyId ? this->id() : 0.
         virtual std::shared_ptr<Node> clone(bool copyId) const = 0;
 
-        /// Execute \a func on all children.
-        virtual void propagateChildren(const std::function<void(Node *)> &func);
+        /// Appends the direct children to \a children in order.
+        virtual void collectChildren(std::vector<Node *> &children) const;
+
+        /// Hands the children over to the teardown list of the thread, which the outermost
+        /// \c ~Node releases one by one, so that deep trees aren't destroyed recursively.
+        /// \note Must be called first by the destructor of the class that holds the children.
+        void deferChildren();
+
+        /// Feeds the own content of the node into \a hasher, the children are hashed apart.
+        virtual void hashContent(ContentHasher &hasher) const;
 
         void notify(Notification *n) override;
 
@@ -80,12 +132,24 @@ namespace ss {
         int _type;
         State _state = Created;
         size_t _id = 0;
-        Node *_parent;
+        Node *_parent = nullptr;
         Model *_model = nullptr;
+        // Position in the parent's container, maintained lazily by the parent. Concurrent readers
+        // of the parent may refresh it at once, always to the same value
+        mutable std::atomic<int> _indexHint = -1;
+
+        // Whether the top of the parent chain is detached in the lowest bit, valid while the
+        // other bits equal the structure epoch of the model. Readers fill it in concurrently,
+        // which is why it's a single atomic
+        mutable std::atomic<size_t> _chainState = 0;
+
+        mutable AggregateRecord *_aggregates = nullptr; // Cached values of the aggregates
 
         friend class Model;
         friend class ModelPrivate;
         friend class NodePrivate;
+        friend class AggregateBase;
+        friend class ContentHash;
     };
 
     inline Node::Node(int type) : _type(type) {
@@ -107,6 +171,10 @@ namespace ss {
         return _parent ? _parent->shared_from_this() : nullptr;
     }
 
+    inline Node *Node::parentNode() const {
+        return _parent;
+    }
+
     inline Model *Node::model() const {
         return _model;
     }
@@ -120,8 +188,22 @@ namespace ss {
     }
 
     inline void Node::propagate(const std::function<void(Node *)> &func) {
-        func(this);
-        propagateChildren(func);
+        traverse(func);
+    }
+
+    template <class Func>
+    void Node::traverse(Func &&func) {
+        std::vector<Node *> stack{this};
+        while (!stack.empty()) {
+            auto node = stack.back();
+            stack.pop_back();
+            func(node);
+
+            // Push the children reversed so that the first one is visited first
+            auto size = stack.size();
+            node->collectChildren(stack);
+            std::reverse(stack.begin() + size, stack.end());
+        }
     }
 
 }
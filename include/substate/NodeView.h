@@ -0,0 +1,153 @@
+// Copyright (C) 2022-2025 Stdware Collections (https://www.github.com/stdware)
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef SUBSTATE_NODEVIEW_H
+#define SUBSTATE_NODEVIEW_H
+
+#include <memory>
+#include <cassert>
+#include <iterator>
+
+#include <substate/ArrayView.h>
+
+namespace ss {
+
+    class Node;
+
+    /// NodeView - Read-only view of a node array that yields borrowed \c T pointers.
+    /// \note The shared pointers are never copied, so iterating the view does no reference
+    /// counting. The pointers are valid as long as the children stay in their container. Every
+    /// node must be a \c T or null, which is asserted in debug builds.
+    template <class T>
+    class NodeView {
+    public:
+        using value_type = T *;
+
+        class iterator {
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = T *;
+            using difference_type = ptrdiff_t;
+            using pointer = T *const *;
+            using reference = T *;
+
+            iterator() = default;
+
+            inline explicit iterator(const std::shared_ptr<Node> *ptr) : _ptr(ptr) {
+            }
+
+            inline reference operator*() const {
+                return cast(_ptr->get());
+            }
+            inline reference operator[](difference_type n) const {
+                return cast(_ptr[n].get());
+            }
+
+            inline iterator &operator++() {
+                ++_ptr;
+                return *this;
+            }
+            inline iterator operator++(int) {
+                return iterator(_ptr++);
+            }
+            inline iterator &operator--() {
+                --_ptr;
+                return *this;
+            }
+            inline iterator operator--(int) {
+                return iterator(_ptr--);
+            }
+            inline iterator &operator+=(difference_type n) {
+                _ptr += n;
+                return *this;
+            }
+            inline iterator &operator-=(difference_type n) {
+                _ptr -= n;
+                return *this;
+            }
+            inline iterator operator+(difference_type n) const {
+                return iterator(_ptr + n);
+            }
+            inline iterator operator-(difference_type n) const {
+                return iterator(_ptr - n);
+            }
+            inline difference_type operator-(const iterator &RHS) const {
+                return _ptr - RHS._ptr;
+            }
+
+            inline bool operator==(const iterator &RHS) const {
+                return _ptr == RHS._ptr;
+            }
+            inline bool operator!=(const iterator &RHS) const {
+                return _ptr != RHS._ptr;
+            }
+            inline bool operator<(const iterator &RHS) const {
+                return _ptr < RHS._ptr;
+            }
+            inline bool operator>(const iterator &RHS) const {
+                return _ptr > RHS._ptr;
+            }
+            inline bool operator<=(const iterator &RHS) const {
+                return _ptr <= RHS._ptr;
+            }
+            inline bool operator>=(const iterator &RHS) const {
+                return _ptr >= RHS._ptr;
+            }
+
+            friend inline iterator operator+(difference_type n, const iterator &it) {
+                return it + n;
+            }
+
+        private:
+            const std::shared_ptr<Node> *_ptr = nullptr;
+        };
+        using const_iterator = iterator;
+
+        NodeView() = default;
+
+        inline NodeView(ArrayView<std::shared_ptr<Node>> nodes) : _nodes(nodes) {
+        }
+
+        inline iterator begin() const {
+            return iterator(_nodes.begin());
+        }
+        inline iterator end() const {
+            return iterator(_nodes.end());
+        }
+        inline bool empty() const {
+            return _nodes.empty();
+        }
+        inline size_t size() const {
+            return _nodes.size();
+        }
+
+        inline T *operator[](size_t index) const {
+            assert(index < _nodes.size());
+            return cast(_nodes[index].get());
+        }
+
+        inline T *front() const {
+            return cast(_nodes.front().get());
+        }
+        inline T *back() const {
+            return cast(_nodes.back().get());
+        }
+
+        /// Returns the underlying shared pointers, to take ownership of some of the nodes.
+        inline ArrayView<std::shared_ptr<Node>> nodes() const {
+            return _nodes;
+        }
+
+    protected:
+        // Checked in debug builds, a child of another type would be undefined behavior
+        static inline T *cast(Node *node) {
+            assert(!node || dynamic_cast<T *>(node));
+            return static_cast<T *>(node);
+        }
+
+        ArrayView<std::shared_ptr<Node>> _nodes;
+    };
+
+}
+
+#endif // SUBSTATE_NODEVIEW_H
\ No newline at end of file
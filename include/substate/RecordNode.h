@@ -0,0 +1,126 @@
+// Copyright (C) 2022-2025 Stdware Collections (https://www.github.com/stdware)
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef SUBSTATE_RECORDNODE_H
+#define SUBSTATE_RECORDNODE_H
+
+#include <substate/ArrayView.h>
+#include <substate/Value.h>
+
+namespace ss {
+
+    class RecordAction;
+
+    class RecordNodeBasePrivate;
+
+    /// RecordNodeBase - Record data structure node base, the Qt-free counterpart of
+    /// \c StructNodeBase.
+    class SUBSTATE_EXPORT RecordNodeBase : public Node {
+    public:
+        inline RecordNodeBase(int type, Value *storage, size_t size);
+        ~RecordNodeBase();
+
+    public:
+        inline const Value &at(int index) const;
+        void setAt(int index, Value value);
+
+        inline ArrayView<Value> data() const;
+        inline int count() const;
+        inline int size() const;
+
+    protected:
+        void collectChildren(std::vector<Node *> &children) const override;
+        void hashContent(ContentHasher &hasher) const override;
+
+    protected:
+        Value *_storage;
+        size_t _size;
+
+        static void copy(RecordNodeBase *dest, const RecordNodeBase *src, bool copyId);
+
+        friend class RecordNodeBasePrivate;
+        friend class RecordAction;
+    };
+
+    inline RecordNodeBase::RecordNodeBase(int type, Value *storage, size_t size)
+        : Node(type), _storage(storage), _size(size) {
+    }
+
+    inline const Value &RecordNodeBase::at(int index) const {
+        return _storage[index];
+    }
+
+    inline ArrayView<Value> RecordNodeBase::data() const {
+        return {_storage, _size};
+    }
+
+    inline int RecordNodeBase::count() const {
+        return size();
+    }
+
+    inline int RecordNodeBase::size() const {
+        return int(_size);
+    }
+
+
+    /// RecordNode - Record data structure node with \c N fields.
+    template <size_t N>
+    class RecordNode : public RecordNodeBase {
+    public:
+        inline explicit RecordNode(int type = Record);
+        ~RecordNode();
+
+    protected:
+        std::shared_ptr<Node> clone(bool copyId) const override;
+
+    protected:
+        Value _buf[N];
+    };
+
+    template <size_t N>
+    inline RecordNode<N>::RecordNode(int type) : RecordNodeBase(type, _buf, N) {
+    }
+
+    template <size_t N>
+    RecordNode<N>::~RecordNode() {
+        deferChildren();
+    }
+
+    template <size_t N>
+    inline std::shared_ptr<Node> RecordNode<N>::clone(bool copyId) const {
+        auto node = std::make_shared<RecordNode<N>>(_type);
+        RecordNodeBase::copy(node.get(), this, copyId);
+        return node;
+    }
+
+
+    /// RecordAction - Action for \c RecordNode operations.
+    class SUBSTATE_EXPORT RecordAction : public ValueAction {
+    public:
+        inline RecordAction(const std::shared_ptr<RecordNodeBase> &parent, int index,
+                            Value oldValue, Value value);
+        ~RecordAction();
+
+    public:
+        void execute(bool undo) override;
+
+    public:
+        inline int index() const;
+
+    protected:
+        int _index;
+    };
+
+    inline RecordAction::RecordAction(const std::shared_ptr<RecordNodeBase> &parent, int index,
+                                      Value oldValue, Value value)
+        : ValueAction(RecordAssign, parent, std::move(oldValue), std::move(value)),
+          _index(index) {
+    }
+
+    inline int RecordAction::index() const {
+        return _index;
+    }
+
+}
+
+#endif // SUBSTATE_RECORDNODE_H
\ No newline at end of file
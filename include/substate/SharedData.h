@@ -0,0 +1,65 @@
+// Copyright (C) 2022-2025 Stdware Collections (https://www.github.com/stdware)
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef SUBSTATE_SHAREDDATA_H
+#define SUBSTATE_SHAREDDATA_H
+
+#include <atomic>
+#include <memory>
+
+namespace ss {
+
+    /// SharedData - Implicitly shared value that is copied on the first write while shared.
+    /// \note Copying the holder only shares the value, so that cloning a node doesn't copy its
+    /// payload. An empty holder refers to a default constructed value without allocating.
+    template <class T>
+    class SharedData {
+    public:
+        SharedData() = default;
+
+        inline const T &operator*() const;
+        inline const T *operator->() const;
+
+        /// Returns the value for writing, which is copied first if it's shared. Holders of the
+        /// same value may live on other threads, e.g. clones made by \c Node::parallelClone.
+        inline T &detach();
+
+        inline bool isShared() const;
+
+    protected:
+        std::shared_ptr<T> _d;
+    };
+
+    template <class T>
+    inline const T &SharedData<T>::operator*() const {
+        static const T empty{};
+        return _d ? *_d : empty;
+    }
+
+    template <class T>
+    inline const T *SharedData<T>::operator->() const {
+        return &operator*();
+    }
+
+    template <class T>
+    inline T &SharedData<T>::detach() {
+        if (!_d) {
+            _d = std::make_shared<T>();
+        } else if (_d.use_count() > 1) {
+            _d = std::make_shared<T>(*_d);
+        } else {
+            // The count is a relaxed load, order the write after the last release by another
+            // holder so that its reads of the value are finished
+            std::atomic_thread_fence(std::memory_order_acquire);
+        }
+        return *_d;
+    }
+
+    template <class T>
+    inline bool SharedData<T>::isShared() const {
+        return _d && _d.use_count() > 1;
+    }
+
+}
+
+#endif // SUBSTATE_SHAREDDATA_H
\ No newline at end of file
@@ -4,19 +4,83 @@
 #ifndef SUBSTATE_SHEETNODE_H
 #define SUBSTATE_SHEETNODE_H
 
-#include <set>
-#include <unordered_map>
+#include <memory>
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <iterator>
 
 #include <substate/Node.h>
 #include <substate/Action.h>
+#include <substate/ArrayView.h>
 
 namespace ss {
 
     class SheetAction;
 
+    class SheetBulkAction;
+
     class SheetNodePrivate;
 
+    class SheetNode;
+
+    /// SheetView - Read-only view of the children of a \c SheetNode in ascending id order.
+    class SheetView {
+    public:
+        using value_type = std::pair<int, const std::shared_ptr<Node> &>;
+
+        class iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = SheetView::value_type;
+            using difference_type = ptrdiff_t;
+            using reference = value_type;
+
+            struct pointer {
+                value_type pair;
+                inline const value_type *operator->() const {
+                    return &pair;
+                }
+            };
+
+            iterator() = default;
+
+            inline reference operator*() const;
+            inline pointer operator->() const;
+            inline iterator &operator++();
+            inline iterator operator++(int);
+
+            inline bool operator==(const iterator &RHS) const;
+            inline bool operator!=(const iterator &RHS) const;
+
+        private:
+            inline iterator(const SheetNode *sheet, size_t id);
+
+            const SheetNode *_sheet = nullptr;
+            size_t _id = 0;
+
+            friend class SheetView;
+        };
+        using const_iterator = iterator;
+
+        inline explicit SheetView(const SheetNode *sheet);
+
+        inline iterator begin() const;
+        inline iterator end() const;
+        inline iterator find(int id) const;
+        inline bool contains(int id) const;
+        inline bool empty() const;
+        inline size_t size() const;
+
+    protected:
+        const SheetNode *_sheet;
+    };
+
     /// SheetNode - Auto-incrementing ID map data structure.
+    /// \note The children are stored by id in pages of fixed-size slot arrays, each with a bitmap
+    /// marking the occupied slots. A page is released once its last child is removed, so the
+    /// memory follows the live ids instead of the span between them, which only costs a null page
+    /// pointer every \c PageSize ids. Neither insertion nor removal moves other children.
     class SUBSTATE_EXPORT SheetNode : public Node {
     public:
         inline explicit SheetNode(int type = Sheet);
@@ -24,36 +88,139 @@ namespace ss {
 
     public:
         int insert(const std::shared_ptr<Node> &node);
+        /// Inserts the nodes under the ids <tt>[ret, ret + nodes.size())</tt>, returns -1 if
+        /// there's nothing to insert.
+        int insertMany(std::vector<std::shared_ptr<Node>> nodes);
         bool remove(int id);
         inline std::shared_ptr<Node> at(int id) const;
-        inline const std::unordered_map<int, std::shared_ptr<Node>> &data() const;
+        inline Node *nodeAt(int id) const;
+        inline SheetView data() const;
         inline int count() const;
         inline int size() const;
 
     protected:
         std::shared_ptr<Node> clone(bool copyId) const override;
-        void propagateChildren(const std::function<void(Node *)> &func) override;
+        void collectChildren(std::vector<Node *> &children) const override;
+        void hashContent(ContentHasher &hasher) const override;
+
+        static constexpr const size_t PageBits = 8;
+        static constexpr const size_t PageSize = size_t(1) << PageBits;
+
+        struct Page {
+            std::shared_ptr<Node> slots[PageSize];
+            uint64_t live[PageSize / 64] = {}; // Occupancy bitmap of the slots
+            size_t count = 0;
+        };
+
+        /// Returns the page holding \a id, or null if it's released.
+        inline Page *pageOf(size_t id) const;
+        inline bool isLive(size_t id) const;
+
+        /// Returns the first live id from \a id, or \c endId() if there's none.
+        size_t nextLive(size_t id) const;
+        inline size_t endId() const;
 
-        std::unordered_map<int, std::shared_ptr<Node>> _sheet;
+        Page &page(size_t id);
+        void releasePage(size_t index);
+
+        void setSlot(int id, const std::shared_ptr<Node> &node);
+        void setSlots(int id, ArrayView<std::shared_ptr<Node>> nodes);
+        void clearSlot(int id);
+        void clearSlots(int id, int count);
+
+        std::vector<std::unique_ptr<Page>> _pages; // Page i holds the ids from _firstPage + i
+        size_t _firstPage = 0;
+        int _size = 0;
         int _maxId = 0;
 
+        friend class SheetView;
         friend class SheetNodePrivate;
         friend class SheetAction;
+        friend class SheetBulkAction;
     };
 
+    inline SheetView::iterator::iterator(const SheetNode *sheet, size_t id)
+        : _sheet(sheet), _id(id) {
+    }
+
+    inline SheetView::iterator::reference SheetView::iterator::operator*() const {
+        return {int(_id), _sheet->pageOf(_id)->slots[_id & (SheetNode::PageSize - 1)]};
+    }
+
+    inline SheetView::iterator::pointer SheetView::iterator::operator->() const {
+        return {**this};
+    }
+
+    inline SheetView::iterator &SheetView::iterator::operator++() {
+        _id = _sheet->nextLive(_id + 1);
+        return *this;
+    }
+
+    inline SheetView::iterator SheetView::iterator::operator++(int) {
+        auto it = *this;
+        ++(*this);
+        return it;
+    }
+
+    inline bool SheetView::iterator::operator==(const iterator &RHS) const {
+        return _id == RHS._id;
+    }
+
+    inline bool SheetView::iterator::operator!=(const iterator &RHS) const {
+        return _id != RHS._id;
+    }
+
+    inline SheetView::SheetView(const SheetNode *sheet) : _sheet(sheet) {
+    }
+
+    inline SheetView::iterator SheetView::begin() const {
+        return {_sheet, _sheet->nextLive(0)};
+    }
+
+    inline SheetView::iterator SheetView::end() const {
+        return {_sheet, _sheet->endId()};
+    }
+
+    inline SheetView::iterator SheetView::find(int id) const {
+        if (!_sheet->isLive(size_t(id))) {
+            return end();
+        }
+        return {_sheet, size_t(id)};
+    }
+
+    inline bool SheetView::contains(int id) const {
+        return find(id) != end();
+    }
+
+    inline bool SheetView::empty() const {
+        return _sheet->_size == 0;
+    }
+
+    inline size_t SheetView::size() const {
+        return size_t(_sheet->_size);
+    }
+
     inline SheetNode::SheetNode(int type) : Node(type) {
     }
 
     inline std::shared_ptr<Node> SheetNode::at(int id) const {
-        auto it = _sheet.find(id);
-        if (it == _sheet.end()) {
+        auto page = pageOf(size_t(id));
+        if (!page) {
             return {};
         }
-        return it->second;
+        return page->slots[size_t(id) & (PageSize - 1)];
     }
 
-    inline const std::unordered_map<int, std::shared_ptr<Node>> &SheetNode::data() const {
-        return _sheet;
+    inline Node *SheetNode::nodeAt(int id) const {
+        auto page = pageOf(size_t(id));
+        if (!page) {
+            return nullptr;
+        }
+        return page->slots[size_t(id) & (PageSize - 1)].get();
+    }
+
+    inline SheetView SheetNode::data() const {
+        return SheetView(this);
     }
 
     inline int SheetNode::count() const {
@@ -61,7 +228,26 @@ namespace ss {
     }
 
     inline int SheetNode::size() const {
-        return int(_sheet.size());
+        return _size;
+    }
+
+    inline SheetNode::Page *SheetNode::pageOf(size_t id) const {
+        // Ids in front of the first page wrap around to a large index
+        size_t index = (id >> PageBits) - _firstPage;
+        if (index >= _pages.size()) {
+            return nullptr;
+        }
+        return _pages[index].get();
+    }
+
+    inline bool SheetNode::isLive(size_t id) const {
+        auto page = pageOf(id);
+        size_t slot = id & (PageSize - 1);
+        return page && (page->live[slot >> 6] & (uint64_t(1) << (slot & 63)));
+    }
+
+    inline size_t SheetNode::endId() const {
+        return (_firstPage + _pages.size()) << PageBits;
     }
 
 
@@ -99,6 +285,42 @@ namespace ss {
         return _child;
     }
 
+
+    /// SheetBulkAction - Action for \c SheetNode insertion of children with contiguous ids.
+    class SUBSTATE_EXPORT SheetBulkAction : public NodeAction {
+    public:
+        inline SheetBulkAction(Type type, const std::shared_ptr<SheetNode> &parent, int id,
+                               std::vector<std::shared_ptr<Node>> children);
+        ~SheetBulkAction() = default;
+
+    public:
+        void queryNodes(bool inserted,
+                        const std::function<void(const std::shared_ptr<Node> &)> &add) override;
+        void execute(bool undo) override;
+
+    public:
+        /// Returns the id of the first child, the i-th child has id \c id()+i.
+        inline int id() const;
+        inline ArrayView<std::shared_ptr<Node>> children() const;
+
+    protected:
+        int _id;
+        std::vector<std::shared_ptr<Node>> _children;
+    };
+
+    inline SheetBulkAction::SheetBulkAction(Type type, const std::shared_ptr<SheetNode> &parent,
+                                            int id, std::vector<std::shared_ptr<Node>> children)
+        : NodeAction(type, parent), _id(id), _children(std::move(children)) {
+    }
+
+    inline int SheetBulkAction::id() const {
+        return _id;
+    }
+
+    inline ArrayView<std::shared_ptr<Node>> SheetBulkAction::children() const {
+        return _children;
+    }
+
 }
 
 #endif // SUBSTATE_SHEETNODE_H
\ No newline at end of file
@@ -0,0 +1,268 @@
+// Copyright (C) 2022-2025 Stdware Collections (https://www.github.com/stdware)
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef SUBSTATE_SORTEDNODE_H
+#define SUBSTATE_SORTEDNODE_H
+
+#include <vector>
+#include <iterator>
+
+#include <substate/Node.h>
+#include <substate/Action.h>
+#include <substate/Treap.h>
+#include <substate/Value.h>
+
+namespace ss {
+
+    class SortedAction;
+
+    class SortedRekeyAction;
+
+    class SortedNodePrivate;
+
+    /// SortedItem - Child of a \c SortedNode with the key it's ordered by.
+    struct SortedItem {
+        int id;
+        Value key;
+        std::shared_ptr<Node> node;
+    };
+
+    /// SortedTraits - Order statistic tree traits of \c SortedNode, each subtree keeps the count
+    /// of its items.
+    struct SortedTraits {
+        using value_type = SortedItem;
+
+        struct summary_type {
+            int count = 0;
+        };
+
+        static inline summary_type measure(const SortedItem &) {
+            return {1};
+        }
+        static inline summary_type combine(const summary_type &a, const summary_type &b) {
+            return {a.count + b.count};
+        }
+    };
+
+    /// SortedView - Read-only view of the items of a \c SortedNode in ascending key order.
+    class SortedView {
+    public:
+        using Tree = Treap<SortedTraits>;
+
+        class iterator {
+        public:
+            using iterator_category = std::bidirectional_iterator_tag;
+            using value_type = SortedItem;
+            using difference_type = ptrdiff_t;
+            using pointer = const SortedItem *;
+            using reference = const SortedItem &;
+
+            iterator() = default;
+
+            inline reference operator*() const {
+                return _node->value;
+            }
+            inline pointer operator->() const {
+                return &_node->value;
+            }
+            inline iterator &operator++() {
+                _node = Tree::next(_node);
+                return *this;
+            }
+            inline iterator operator++(int) {
+                auto it = *this;
+                ++(*this);
+                return it;
+            }
+            inline bool operator==(const iterator &RHS) const {
+                return _node == RHS._node;
+            }
+            inline bool operator!=(const iterator &RHS) const {
+                return _node != RHS._node;
+            }
+
+        private:
+            inline explicit iterator(const Tree::Node *node) : _node(node) {
+            }
+
+            const Tree::Node *_node = nullptr;
+
+            friend class SortedView;
+        };
+        using const_iterator = iterator;
+
+        inline explicit SortedView(const Tree *tree) : _tree(tree) {
+        }
+
+        inline iterator begin() const {
+            return iterator(_tree->first());
+        }
+        inline iterator end() const {
+            return iterator(nullptr);
+        }
+        inline bool empty() const {
+            return _tree->empty();
+        }
+        inline size_t size() const {
+            return size_t(_tree->summary().count);
+        }
+
+    protected:
+        const Tree *_tree;
+    };
+
+    /// SortedNode - Auto-incrementing ID map whose children are kept in ascending key order,
+    /// children with equivalent keys are ordered by id. Keys are compared by \c Value::operator<,
+    /// so integer and double keys interleave by numeric value.
+    /// \note The children live in an order statistic tree, so the rank of a child and the child
+    /// of a rank are both found in O(log n) and ordered iteration needs no sorting.
+    class SUBSTATE_EXPORT SortedNode : public Node {
+    public:
+        inline explicit SortedNode(int type = Sorted);
+        ~SortedNode();
+
+    public:
+        int insert(const std::shared_ptr<Node> &node, Value key);
+        bool remove(int id);
+        bool rekey(int id, Value key);
+        inline std::shared_ptr<Node> at(int id) const;
+        inline Node *nodeAt(int id) const;
+        inline const SortedItem *item(int id) const;
+        inline SortedView data() const;
+        inline int count() const;
+        inline int size() const;
+
+        /// Returns the position of the child in key order, or -1 if there's no such child.
+        int rank(int id) const;
+        /// Returns the item at \a rank in key order.
+        const SortedItem &select(int rank) const;
+
+        /// Returns the rank of the first item whose key isn't less than \a key.
+        int lowerBound(const Value &key) const;
+        /// Returns the rank of the first item whose key is greater than \a key.
+        int upperBound(const Value &key) const;
+
+    protected:
+        using Tree = SortedView::Tree;
+
+        std::shared_ptr<Node> clone(bool copyId) const override;
+        void collectChildren(std::vector<Node *> &children) const override;
+        void hashContent(ContentHasher &hasher) const override;
+
+        void insertItem(const SortedItem &item);
+        SortedItem removeItem(int id);
+
+        Tree _tree;
+        std::vector<Tree::Node *> _index; // Tree node of each id
+        int _maxId = 0;
+
+        friend class SortedNodePrivate;
+        friend class SortedAction;
+        friend class SortedRekeyAction;
+    };
+
+    inline SortedNode::SortedNode(int type) : Node(type) {
+    }
+
+    inline std::shared_ptr<Node> SortedNode::at(int id) const {
+        auto item = this->item(id);
+        return item ? item->node : nullptr;
+    }
+
+    inline Node *SortedNode::nodeAt(int id) const {
+        auto item = this->item(id);
+        return item ? item->node.get() : nullptr;
+    }
+
+    inline const SortedItem *SortedNode::item(int id) const {
+        if (size_t(id) >= _index.size() || !_index[id]) {
+            return nullptr;
+        }
+        return &_index[id]->value;
+    }
+
+    inline SortedView SortedNode::data() const {
+        return SortedView(&_tree);
+    }
+
+    inline int SortedNode::count() const {
+        return size();
+    }
+
+    inline int SortedNode::size() const {
+        return _tree.summary().count;
+    }
+
+
+    /// SortedAction - Action for \c SortedNode insertion or deletion.
+    class SUBSTATE_EXPORT SortedAction : public NodeAction {
+    public:
+        inline SortedAction(Type type, const std::shared_ptr<SortedNode> &parent, SortedItem item);
+        ~SortedAction() = default;
+
+    public:
+        void queryNodes(bool inserted,
+                        const std::function<void(const std::shared_ptr<Node> &)> &add) override;
+        void execute(bool undo) override;
+
+    public:
+        inline const SortedItem &item() const;
+
+    protected:
+        SortedItem _item;
+    };
+
+    inline SortedAction::SortedAction(Type type, const std::shared_ptr<SortedNode> &parent,
+                                      SortedItem item)
+        : NodeAction(type, parent), _item(std::move(item)) {
+    }
+
+    inline const SortedItem &SortedAction::item() const {
+        return _item;
+    }
+
+
+    /// SortedRekeyAction - Action for \c SortedNode key change of a child.
+    class SUBSTATE_EXPORT SortedRekeyAction : public NodeAction {
+    public:
+        inline SortedRekeyAction(const std::shared_ptr<SortedNode> &parent, int id, Value oldKey,
+                                 Value key);
+        ~SortedRekeyAction() = default;
+
+    public:
+        void queryNodes(bool inserted,
+                        const std::function<void(const std::shared_ptr<Node> &)> &add) override;
+        void execute(bool undo) override;
+
+    public:
+        inline int id() const;
+        inline const Value &oldKey() const;
+        inline const Value &key() const;
+
+    protected:
+        int _id;
+        Value _oldKey;
+        Value _key;
+    };
+
+    inline SortedRekeyAction::SortedRekeyAction(const std::shared_ptr<SortedNode> &parent, int id,
+                                                Value oldKey, Value key)
+        : NodeAction(SortedRekey, parent), _id(id), _oldKey(std::move(oldKey)),
+          _key(std::move(key)) {
+    }
+
+    inline int SortedRekeyAction::id() const {
+        return _id;
+    }
+
+    inline const Value &SortedRekeyAction::oldKey() const {
+        return _oldKey;
+    }
+
+    inline const Value &SortedRekeyAction::key() const {
+        return _key;
+    }
+
+}
+
+#endif // SUBSTATE_SORTEDNODE_H
\ No newline at end of file
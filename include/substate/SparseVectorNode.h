@@ -0,0 +1,360 @@
+// Copyright (C) 2022-2025 Stdware Collections (https://www.github.com/stdware)
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef SUBSTATE_SPARSEVECTORNODE_H
+#define SUBSTATE_SPARSEVECTORNODE_H
+
+#include <vector>
+#include <utility>
+#include <iterator>
+
+#include <substate/Node.h>
+#include <substate/Action.h>
+#include <substate/ArrayView.h>
+#include <substate/Treap.h>
+
+namespace ss {
+
+    class SparseVectorInsDelAction;
+
+    class SparseVectorMoveAction;
+
+    class SparseVectorReplaceAction;
+
+    class SparseVectorNodePrivate;
+
+    /// SparseVectorItem - Occupied slot of a \c SparseVectorNode.
+    struct SparseVectorItem {
+        int index;
+        std::shared_ptr<Node> node;
+    };
+
+    /// SparseVectorEntry - Child of a \c SparseVectorNode with the count of empty slots between
+    /// the previous child and itself.
+    struct SparseVectorEntry {
+        int gap;
+        std::shared_ptr<Node> node;
+    };
+
+    /// SparseVectorTraits - Implicit tree traits of \c SparseVectorNode, each subtree keeps the
+    /// count of slots it spans and the count of children it holds.
+    struct SparseVectorTraits {
+        using value_type = SparseVectorEntry;
+
+        struct summary_type {
+            int length = 0;
+            int count = 0;
+        };
+
+        static inline summary_type measure(const SparseVectorEntry &entry) {
+            return {entry.gap + 1, 1};
+        }
+        static inline summary_type combine(const summary_type &a, const summary_type &b) {
+            return {a.length + b.length, a.count + b.count};
+        }
+    };
+
+    /// SparseVectorView - Read-only view of the occupied slots of a \c SparseVectorNode in
+    /// ascending index order, empty slots are skipped.
+    class SparseVectorView {
+    public:
+        using Tree = Treap<SparseVectorTraits>;
+        using value_type = std::pair<int, const std::shared_ptr<Node> &>;
+
+        class iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = SparseVectorView::value_type;
+            using difference_type = ptrdiff_t;
+            using reference = value_type;
+
+            struct pointer {
+                value_type pair;
+                inline const value_type *operator->() const {
+                    return &pair;
+                }
+            };
+
+            iterator() = default;
+
+            inline reference operator*() const {
+                return {_index, _node->value.node};
+            }
+            inline pointer operator->() const {
+                return {**this};
+            }
+            inline iterator &operator++() {
+                _node = Tree::next(_node);
+                if (_node)
+                    _index += _node->value.gap + 1;
+                return *this;
+            }
+            inline iterator operator++(int) {
+                auto it = *this;
+                ++(*this);
+                return it;
+            }
+            inline bool operator==(const iterator &RHS) const {
+                return _node == RHS._node;
+            }
+            inline bool operator!=(const iterator &RHS) const {
+                return _node != RHS._node;
+            }
+
+        private:
+            inline explicit iterator(const Tree::Node *node)
+                : _node(node), _index(node ? node->value.gap : 0) {
+            }
+
+            const Tree::Node *_node = nullptr;
+            int _index = 0;
+
+            friend class SparseVectorView;
+        };
+        using const_iterator = iterator;
+
+        inline explicit SparseVectorView(const Tree *tree) : _tree(tree) {
+        }
+
+        inline iterator begin() const {
+            return iterator(_tree->first());
+        }
+        inline iterator end() const {
+            return iterator(nullptr);
+        }
+        inline bool empty() const {
+            return _tree->empty();
+        }
+        inline size_t size() const {
+            return size_t(_tree->summary().count);
+        }
+
+    protected:
+        const Tree *_tree;
+    };
+
+    /// SparseVectorNode - Vector data structure node for long and mostly empty lists.
+    /// \note Only the occupied slots are stored, each with the count of empty slots before it, in
+    /// an implicit tree. Insertion, deletion and movement shift the indexes behind them by
+    /// splitting and merging the tree in O(log n) plus the count of children involved.
+    class SUBSTATE_EXPORT SparseVectorNode : public Node {
+    public:
+        inline explicit SparseVectorNode(int type = SparseVector);
+        ~SparseVectorNode();
+
+    public:
+        inline void prepend(const std::shared_ptr<Node> &node);
+        inline void append(const std::shared_ptr<Node> &node);
+        inline void insert(int index, const std::shared_ptr<Node> &node);
+        inline void removeOne(int index);
+        void insert(int index, std::vector<std::shared_ptr<Node>> nodes); // null: empty slot
+        void insertEmpty(int index, int count);
+        void move(int index, int count, int dest);         // dest: destination index before move
+        inline void move2(int index, int count, int dest); // dest: destination index after move
+        void remove(int index, int count);
+        void replace(int index, const std::shared_ptr<Node> &node); // null: empty the slot
+        inline void resize(int size);
+        std::shared_ptr<Node> at(int index) const;
+        inline SparseVectorView data() const;
+        inline int count() const;
+        inline int size() const;
+        inline int childCount() const;
+
+        /// Returns the index of the first occupied slot at or behind \a index, or \c size() if
+        /// there's none.
+        int nextIndex(int index) const;
+
+    protected:
+        using Tree = SparseVectorView::Tree;
+
+        std::shared_ptr<Node> clone(bool copyId) const override;
+        void collectChildren(std::vector<Node *> &children) const override;
+        void hashContent(ContentHasher &hasher) const override;
+
+        Tree _tree;
+        int _size = 0;
+
+        friend class SparseVectorNodePrivate;
+        friend class SparseVectorInsDelAction;
+        friend class SparseVectorMoveAction;
+        friend class SparseVectorReplaceAction;
+    };
+
+    inline SparseVectorNode::SparseVectorNode(int type) : Node(type) {
+    }
+
+    inline void SparseVectorNode::prepend(const std::shared_ptr<Node> &node) {
+        insert(0, node);
+    }
+
+    inline void SparseVectorNode::append(const std::shared_ptr<Node> &node) {
+        insert(size(), node);
+    }
+
+    inline void SparseVectorNode::insert(int index, const std::shared_ptr<Node> &node) {
+        insert(index, std::vector<std::shared_ptr<Node>>{node});
+    }
+
+    inline void SparseVectorNode::removeOne(int index) {
+        remove(index, 1);
+    }
+
+    inline void SparseVectorNode::move2(int index, int count, int dest) {
+        move(index, count, (dest <= index) ? dest : (dest + count));
+    }
+
+    inline void SparseVectorNode::resize(int size) {
+        if (size > _size) {
+            insertEmpty(_size, size - _size);
+        } else if (size < _size) {
+            remove(size, _size - size);
+        }
+    }
+
+    inline SparseVectorView SparseVectorNode::data() const {
+        return SparseVectorView(&_tree);
+    }
+
+    inline int SparseVectorNode::count() const {
+        return size();
+    }
+
+    inline int SparseVectorNode::size() const {
+        return _size;
+    }
+
+    inline int SparseVectorNode::childCount() const {
+        return _tree.summary().count;
+    }
+
+
+    /// SparseVectorInsDelAction - Action for \c SparseVectorNode insertion or deletion.
+    class SUBSTATE_EXPORT SparseVectorInsDelAction : public NodeAction {
+    public:
+        inline SparseVectorInsDelAction(Type type, const std::shared_ptr<SparseVectorNode> &parent,
+                                        int index, int count, std::vector<SparseVectorItem> items);
+        ~SparseVectorInsDelAction() = default;
+
+    public:
+        void queryNodes(bool inserted,
+                        const std::function<void(const std::shared_ptr<Node> &)> &add) override;
+        void execute(bool undo) override;
+
+    public:
+        inline int index() const;
+        inline int count() const;
+
+        /// Returns the occupied slots of the range in ascending order, the indexes are relative
+        /// to \c index().
+        inline ArrayView<SparseVectorItem> items() const;
+
+    protected:
+        int _index, _count;
+        std::vector<SparseVectorItem> _items;
+    };
+
+    inline SparseVectorInsDelAction::SparseVectorInsDelAction(
+        Type type, const std::shared_ptr<SparseVectorNode> &parent, int index, int count,
+        std::vector<SparseVectorItem> items)
+        : NodeAction(type, parent), _index(index), _count(count), _items(std::move(items)) {
+    }
+
+    inline int SparseVectorInsDelAction::index() const {
+        return _index;
+    }
+
+    inline int SparseVectorInsDelAction::count() const {
+        return _count;
+    }
+
+    inline ArrayView<SparseVectorItem> SparseVectorInsDelAction::items() const {
+        return _items;
+    }
+
+
+    /// SparseVectorMoveAction - Action for \c SparseVectorNode movement.
+    class SUBSTATE_EXPORT SparseVectorMoveAction : public NodeAction {
+    public:
+        inline SparseVectorMoveAction(const std::shared_ptr<SparseVectorNode> &parent, int index,
+                                      int count, int dest);
+        ~SparseVectorMoveAction() = default;
+
+    public:
+        void queryNodes(bool inserted,
+                        const std::function<void(const std::shared_ptr<Node> &)> &add) override;
+        void execute(bool undo) override;
+
+    public:
+        inline int index() const;
+        inline int count() const;
+        inline int destination() const;
+
+    protected:
+        int _index, _count, _dest;
+    };
+
+    inline SparseVectorMoveAction::SparseVectorMoveAction(
+        const std::shared_ptr<SparseVectorNode> &parent, int index, int count, int dest)
+        : NodeAction(SparseVectorMove, parent), _index(index), _count(count), _dest(dest) {
+    }
+
+    inline int SparseVectorMoveAction::index() const {
+        return _index;
+    }
+
+    inline int SparseVectorMoveAction::count() const {
+        return _count;
+    }
+
+    inline int SparseVectorMoveAction::destination() const {
+        return _dest;
+    }
+
+
+    /// SparseVectorReplaceAction - Action for \c SparseVectorNode replacement of a slot, either
+    /// child may be null for an empty slot.
+    class SUBSTATE_EXPORT SparseVectorReplaceAction : public NodeAction {
+    public:
+        inline SparseVectorReplaceAction(const std::shared_ptr<SparseVectorNode> &parent,
+                                         int index, const std::shared_ptr<Node> &oldChild,
+                                         const std::shared_ptr<Node> &child);
+        ~SparseVectorReplaceAction() = default;
+
+    public:
+        void queryNodes(bool inserted,
+                        const std::function<void(const std::shared_ptr<Node> &)> &add) override;
+        void execute(bool undo) override;
+
+    public:
+        inline int index() const;
+        inline std::shared_ptr<Node> oldChild() const;
+        inline std::shared_ptr<Node> child() const;
+
+    protected:
+        int _index;
+        std::shared_ptr<Node> _oldChild;
+        std::shared_ptr<Node> _child;
+    };
+
+    inline SparseVectorReplaceAction::SparseVectorReplaceAction(
+        const std::shared_ptr<SparseVectorNode> &parent, int index,
+        const std::shared_ptr<Node> &oldChild, const std::shared_ptr<Node> &child)
+        : NodeAction(SparseVectorReplace, parent), _index(index), _oldChild(oldChild),
+          _child(child) {
+    }
+
+    inline int SparseVectorReplaceAction::index() const {
+        return _index;
+    }
+
+    inline std::shared_ptr<Node> SparseVectorReplaceAction::oldChild() const {
+        return _oldChild;
+    }
+
+    inline std::shared_ptr<Node> SparseVectorReplaceAction::child() const {
+        return _child;
+    }
+
+}
+
+#endif // SUBSTATE_SPARSEVECTORNODE_H
\ No newline at end of file
@@ -8,10 +8,10 @@
 #include <map>
 #include <vector>
 #include <memory>
-#include <unordered_map>
 
 #include <substate/Node.h>
 #include <substate/Action.h>
+#include <substate/IdTable.h>
 
 namespace ss {
 
@@ -33,6 +33,7 @@ namespace ss {
         inline Model *model() const;
 
         inline std::shared_ptr<Node> indexOf(size_t id) const;
+        inline Node *find(size_t id) const;
 
         /// Sets up the engine with a model, must set \c this->_model to \c model after this call.
         virtual void setup(Model *model);
@@ -52,7 +53,7 @@ namespace ss {
         /// Executes undo or redo and updates engine's internal state.
         virtual void execute(bool undo) = 0;
 
-        /// Resets the engine and model.
+        /// Resets the engine and model, destroying the nodes and actions one by one.
         virtual void reset();
 
         virtual int minimum() const = 0;
@@ -64,7 +65,11 @@ namespace ss {
         size_t addId(Node *node, size_t idx = 0);
         inline void removeId(size_t idx);
 
-        std::unordered_map<size_t, Node *> _idMap;
+        /// Clears the ids after the nodes have been released in \c Model::_clearing mode, the
+        /// nodes that are still referenced from outside are turned into free nodes.
+        void releaseIds();
+
+        IdTable _ids;
         size_t _maxId = 0;
         Model *_model = nullptr;
 
@@ -77,16 +82,20 @@ namespace ss {
         return _model;
     }
 
+    inline Node *StorageEngine::find(size_t id) const {
+        return _ids.find(id);
+    }
+
     inline std::shared_ptr<Node> StorageEngine::indexOf(size_t id) const {
-        auto it = _idMap.find(id);
-        if (it == _idMap.end()) {
+        auto node = _ids.find(id);
+        if (!node) {
             return nullptr;
         }
-        return it->second->shared_from_this();
+        return node->shared_from_this();
     }
 
     inline void StorageEngine::removeId(size_t idx) {
-        _idMap.erase(idx);
+        _ids.erase(idx);
     }
 
 }
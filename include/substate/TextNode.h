@@ -0,0 +1,197 @@
+// Copyright (C) 2022-2025 Stdware Collections (https://www.github.com/stdware)
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef SUBSTATE_TEXTNODE_H
+#define SUBSTATE_TEXTNODE_H
+
+#include <string>
+#include <string_view>
+
+#include <substate/Node.h>
+#include <substate/Action.h>
+#include <substate/Treap.h>
+#include <substate/SharedData.h>
+
+namespace ss {
+
+    class TextAction;
+
+    class TextNodePrivate;
+
+    /// TextChunk - Leaf of the rope of a \c TextNode, never splits a UTF-8 sequence.
+    struct TextChunk {
+        std::string text;
+        int chars = 0; // Code points
+        int lines = 0; // Line feeds
+    };
+
+    /// TextTraits - Rope traits of \c TextNode, each subtree keeps its byte, code point and line
+    /// feed counts.
+    struct TextTraits {
+        using value_type = TextChunk;
+
+        struct summary_type {
+            int bytes = 0;
+            int chars = 0;
+            int lines = 0;
+        };
+
+        static inline summary_type measure(const TextChunk &chunk) {
+            return {int(chunk.text.size()), chunk.chars, chunk.lines};
+        }
+        static inline summary_type combine(const summary_type &a, const summary_type &b) {
+            return {a.bytes + b.bytes, a.chars + b.chars, a.lines + b.lines};
+        }
+    };
+
+    /// TextTree - Rope of a \c TextNode, copying it copies every chunk.
+    class TextTree : public Treap<TextTraits> {
+    public:
+        TextTree() = default;
+        inline TextTree(const TextTree &other);
+    };
+
+    inline TextTree::TextTree(const TextTree &other) : Treap() {
+        other.forEach([this](const TextChunk &chunk) {
+            pushBack(chunk); //
+        });
+    }
+
+    /// TextNode - UTF-8 text data structure node.
+    /// \note The text is stored as a rope of chunks of at most \c ChunkSize bytes. Offsets are in
+    /// bytes and must fall on code point boundaries, lines are separated by line feeds. Byte
+    /// offsets, code point indexes and line numbers convert into each other in O(log n).
+    class SUBSTATE_EXPORT TextNode : public Node {
+    public:
+        inline explicit TextNode(int type = Text);
+        ~TextNode();
+
+        static constexpr const int ChunkSize = 1024;
+
+    public:
+        inline void prepend(std::string text);
+        inline void append(std::string text);
+        void insert(int offset, std::string text);
+        void remove(int offset, int size);
+        inline void clear();
+
+        std::string text() const;
+        std::string text(int offset, int size) const;
+        inline int count() const;
+        inline int size() const;
+        inline int charCount() const;
+        inline int lineCount() const;
+
+        /// Returns the byte offset of the first byte of \a line.
+        int lineOffset(int line) const;
+        /// Returns the line containing the byte at \a offset.
+        int lineAt(int offset) const;
+        /// Returns the content of \a line without its line feed.
+        std::string line(int line) const;
+
+        /// Returns the byte offset of the code point at \a index.
+        int charOffset(int index) const;
+        /// Returns the index of the code point starting at \a offset.
+        int charIndex(int offset) const;
+
+        bool isBoundary(int offset) const;
+
+        /// Calls \a func with a \c std::string_view of every chunk in order.
+        template <class Func>
+        void forEachChunk(Func &&func) const;
+
+    protected:
+        using Tree = Treap<TextTraits>;
+
+        std::shared_ptr<Node> clone(bool copyId) const override;
+        void hashContent(ContentHasher &hasher) const override;
+
+        Tree::Node *findByte(int offset, TextTraits::summary_type &before) const;
+        Tree::Node *findChar(int index, TextTraits::summary_type &before) const;
+        Tree::Node *findLine(int line, TextTraits::summary_type &before) const;
+
+        void insertText(int offset, std::string_view text);
+        void removeText(int offset, int size);
+
+        SharedData<TextTree> _tree;
+
+        friend class TextNodePrivate;
+        friend class TextAction;
+    };
+
+    inline TextNode::TextNode(int type) : Node(type) {
+    }
+
+    inline void TextNode::prepend(std::string text) {
+        insert(0, std::move(text));
+    }
+
+    inline void TextNode::append(std::string text) {
+        insert(size(), std::move(text));
+    }
+
+    inline void TextNode::clear() {
+        remove(0, size());
+    }
+
+    inline int TextNode::count() const {
+        return size();
+    }
+
+    inline int TextNode::size() const {
+        return _tree->summary().bytes;
+    }
+
+    inline int TextNode::charCount() const {
+        return _tree->summary().chars;
+    }
+
+    inline int TextNode::lineCount() const {
+        return _tree->summary().lines + 1;
+    }
+
+    template <class Func>
+    void TextNode::forEachChunk(Func &&func) const {
+        _tree->forEach([&func](const TextChunk &chunk) {
+            func(std::string_view(chunk.text)); //
+        });
+    }
+
+
+    /// TextAction - Action for \c TextNode insertion or deletion.
+    class SUBSTATE_EXPORT TextAction : public NodeAction {
+    public:
+        inline TextAction(Type type, const std::shared_ptr<TextNode> &parent, int offset,
+                          std::string text);
+        ~TextAction() = default;
+
+    public:
+        inline int offset() const;
+        inline const std::string &text() const;
+
+    public:
+        void queryNodes(bool inserted,
+                        const std::function<void(const std::shared_ptr<Node> &)> &add) override;
+        void execute(bool undo) override;
+
+    protected:
+        int _offset;
+        std::string _text;
+    };
+
+    inline TextAction::TextAction(Type type, const std::shared_ptr<TextNode> &parent, int offset,
+                                  std::string text)
+        : NodeAction(type, parent), _offset(offset), _text(std::move(text)) {
+    }
+
+    inline int TextAction::offset() const {
+        return _offset;
+    }
+
+    inline const std::string &TextAction::text() const {
+        return _text;
+    }
+
+}
+
+#endif // SUBSTATE_TEXTNODE_H
\ No newline at end of file
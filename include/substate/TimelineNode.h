@@ -0,0 +1,311 @@
+// Copyright (C) 2022-2025 Stdware Collections (https://www.github.com/stdware)
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef SUBSTATE_TIMELINENODE_H
+#define SUBSTATE_TIMELINENODE_H
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <iterator>
+
+#include <substate/Node.h>
+#include <substate/Action.h>
+#include <substate/Treap.h>
+
+namespace ss {
+
+    class TimelineAction;
+
+    class TimelineRepositionAction;
+
+    class TimelineNodePrivate;
+
+    /// TimelineItem - Child of a \c TimelineNode with the interval it occupies.
+    struct TimelineItem {
+        int id;
+        int start;
+        int length;
+        std::shared_ptr<Node> node;
+
+        /// Returns the end of the interval, a zero-length item is treated as a point that
+        /// occupies <tt>[start, start + 1)</tt>.
+        inline int end() const;
+    };
+
+    inline int TimelineItem::end() const {
+        return start + std::max(length, 1);
+    }
+
+    /// TimelineTraits - Interval tree traits of \c TimelineNode, each subtree keeps its maximum
+    /// end.
+    struct TimelineTraits {
+        using value_type = TimelineItem;
+
+        struct summary_type {
+            int maxEnd = std::numeric_limits<int>::min();
+        };
+
+        static inline summary_type measure(const TimelineItem &item) {
+            return {item.end()};
+        }
+        static inline summary_type combine(const summary_type &a, const summary_type &b) {
+            return {std::max(a.maxEnd, b.maxEnd)};
+        }
+    };
+
+    /// TimelineView - Read-only view of the items of a \c TimelineNode in ascending start order.
+    class TimelineView {
+    public:
+        using Tree = Treap<TimelineTraits>;
+
+        class iterator {
+        public:
+            using iterator_category = std::bidirectional_iterator_tag;
+            using value_type = TimelineItem;
+            using difference_type = ptrdiff_t;
+            using pointer = const TimelineItem *;
+            using reference = const TimelineItem &;
+
+            iterator() = default;
+
+            inline reference operator*() const {
+                return _node->value;
+            }
+            inline pointer operator->() const {
+                return &_node->value;
+            }
+            inline iterator &operator++() {
+                _node = Tree::next(_node);
+                return *this;
+            }
+            inline iterator operator++(int) {
+                auto it = *this;
+                ++(*this);
+                return it;
+            }
+            inline bool operator==(const iterator &RHS) const {
+                return _node == RHS._node;
+            }
+            inline bool operator!=(const iterator &RHS) const {
+                return _node != RHS._node;
+            }
+
+        private:
+            inline explicit iterator(const Tree::Node *node) : _node(node) {
+            }
+
+            const Tree::Node *_node = nullptr;
+
+            friend class TimelineView;
+        };
+        using const_iterator = iterator;
+
+        inline explicit TimelineView(const Tree *tree, int size) : _tree(tree), _size(size) {
+        }
+
+        inline iterator begin() const {
+            return iterator(_tree->first());
+        }
+        inline iterator end() const {
+            return iterator(nullptr);
+        }
+        inline bool empty() const {
+            return _size == 0;
+        }
+        inline size_t size() const {
+            return size_t(_size);
+        }
+
+    protected:
+        const Tree *_tree;
+        int _size;
+    };
+
+    /// TimelineNode - Auto-incrementing ID map whose children occupy intervals on a timeline, the
+    /// children are ordered by start in an interval tree to answer overlap queries.
+    class SUBSTATE_EXPORT TimelineNode : public Node {
+    public:
+        inline explicit TimelineNode(int type = Timeline);
+        ~TimelineNode();
+
+    public:
+        int insert(const std::shared_ptr<Node> &node, int start, int length);
+        bool remove(int id);
+        bool reposition(int id, int start, int length);
+        inline std::shared_ptr<Node> at(int id) const;
+        inline Node *nodeAt(int id) const;
+        inline const TimelineItem *item(int id) const;
+        inline TimelineView data() const;
+        inline int count() const;
+        inline int size() const;
+
+        /// Calls \a func with every item overlapping <tt>[begin, end)</tt> in ascending start
+        /// order. Subtrees ending before \a begin or starting after \a end are skipped, so only
+        /// the paths leading to reported items are visited.
+        template <class Func>
+        void overlaps(int begin, int end, Func &&func) const;
+        std::vector<int> overlaps(int begin, int end) const;
+
+    protected:
+        using Tree = TimelineView::Tree;
+
+        std::shared_ptr<Node> clone(bool copyId) const override;
+        void collectChildren(std::vector<Node *> &children) const override;
+        void hashContent(ContentHasher &hasher) const override;
+
+        void insertItem(const TimelineItem &item);
+        TimelineItem removeItem(int id);
+
+        template <class Func>
+        static void overlaps(const Tree::Node *node, int begin, int end, Func &func);
+
+        Tree _tree;
+        std::vector<Tree::Node *> _index; // Tree node of each id
+        int _size = 0;
+        int _maxId = 0;
+
+        friend class TimelineNodePrivate;
+        friend class TimelineAction;
+        friend class TimelineRepositionAction;
+    };
+
+    inline TimelineNode::TimelineNode(int type) : Node(type) {
+    }
+
+    inline std::shared_ptr<Node> TimelineNode::at(int id) const {
+        auto item = this->item(id);
+        return item ? item->node : nullptr;
+    }
+
+    inline Node *TimelineNode::nodeAt(int id) const {
+        auto item = this->item(id);
+        return item ? item->node.get() : nullptr;
+    }
+
+    inline const TimelineItem *TimelineNode::item(int id) const {
+        if (size_t(id) >= _index.size() || !_index[id]) {
+            return nullptr;
+        }
+        return &_index[id]->value;
+    }
+
+    inline TimelineView TimelineNode::data() const {
+        return TimelineView(&_tree, _size);
+    }
+
+    inline int TimelineNode::count() const {
+        return size();
+    }
+
+    inline int TimelineNode::size() const {
+        return _size;
+    }
+
+    template <class Func>
+    void TimelineNode::overlaps(int begin, int end, Func &&func) const {
+        overlaps(_tree.root(), begin, end, func);
+    }
+
+    template <class Func>
+    void TimelineNode::overlaps(const Tree::Node *node, int begin, int end, Func &func) {
+        while (node && node->summary.maxEnd > begin) {
+            overlaps(node->left, begin, end, func);
+
+            // This node and the right subtree start too late
+            const auto &item = node->value;
+            if (item.start >= end) {
+                break;
+            }
+            if (item.end() > begin) {
+                func(item);
+            }
+            node = node->right;
+        }
+    }
+
+
+    /// TimelineAction - Action for \c TimelineNode insertion or deletion.
+    class SUBSTATE_EXPORT TimelineAction : public NodeAction {
+    public:
+        inline TimelineAction(Type type, const std::shared_ptr<TimelineNode> &parent,
+                              TimelineItem item);
+        ~TimelineAction() = default;
+
+    public:
+        void queryNodes(bool inserted,
+                        const std::function<void(const std::shared_ptr<Node> &)> &add) override;
+        void execute(bool undo) override;
+
+    public:
+        inline const TimelineItem &item() const;
+
+    protected:
+        TimelineItem _item;
+    };
+
+    inline TimelineAction::TimelineAction(Type type, const std::shared_ptr<TimelineNode> &parent,
+                                          TimelineItem item)
+        : NodeAction(type, parent), _item(std::move(item)) {
+    }
+
+    inline const TimelineItem &TimelineAction::item() const {
+        return _item;
+    }
+
+
+    /// TimelineRepositionAction - Action for \c TimelineNode interval change of a child.
+    class SUBSTATE_EXPORT TimelineRepositionAction : public NodeAction {
+    public:
+        inline TimelineRepositionAction(const std::shared_ptr<TimelineNode> &parent, int id,
+                                        int oldStart, int oldLength, int start, int length);
+        ~TimelineRepositionAction() = default;
+
+    public:
+        void queryNodes(bool inserted,
+                        const std::function<void(const std::shared_ptr<Node> &)> &add) override;
+        void execute(bool undo) override;
+
+    public:
+        inline int id() const;
+        inline int oldStart() const;
+        inline int oldLength() const;
+        inline int start() const;
+        inline int length() const;
+
+    protected:
+        int _id;
+        int _oldStart, _oldLength;
+        int _start, _length;
+    };
+
+    inline TimelineRepositionAction::TimelineRepositionAction(
+        const std::shared_ptr<TimelineNode> &parent, int id, int oldStart, int oldLength,
+        int start, int length)
+        : NodeAction(TimelineReposition, parent), _id(id), _oldStart(oldStart),
+          _oldLength(oldLength), _start(start), _length(length) {
+    }
+
+    inline int TimelineRepositionAction::id() const {
+        return _id;
+    }
+
+    inline int TimelineRepositionAction::oldStart() const {
+        return _oldStart;
+    }
+
+    inline int TimelineRepositionAction::oldLength() const {
+        return _oldLength;
+    }
+
+    inline int TimelineRepositionAction::start() const {
+        return _start;
+    }
+
+    inline int TimelineRepositionAction::length() const {
+        return _length;
+    }
+
+}
+
+#endif // SUBSTATE_TIMELINENODE_H
\ No newline at end of file
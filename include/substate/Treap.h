@@ -0,0 +1,346 @@
+// Copyright (C) 2022-2025 Stdware Collections (https://www.github.com/stdware)
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef SUBSTATE_TREAP_H
+#define SUBSTATE_TREAP_H
+
+#include <cstdint>
+#include <utility>
+
+namespace ss {
+
+    /// Treap - Randomized balanced binary tree keeping a summary of every subtree, supports split
+    /// and merge in expected O(log n).
+    /// \tparam Traits - Describes the payload, must provide:
+    ///     - \c value_type: the payload type;
+    ///     - \c summary_type: the subtree summary, its default value is the identity;
+    ///     - <tt>static summary_type measure(const value_type &)</tt>;
+    ///     - <tt>static summary_type combine(const summary_type &, const summary_type &)</tt>,
+    ///       which must be associative.
+    template <class Traits>
+    class Treap {
+    public:
+        using value_type = typename Traits::value_type;
+        using summary_type = typename Traits::summary_type;
+
+        struct Node {
+            value_type value;
+            summary_type summary;
+            Node *left = nullptr;
+            Node *right = nullptr;
+            Node *parent = nullptr;
+            uint32_t priority;
+
+            inline Node(value_type value, uint32_t priority)
+                : value(std::move(value)), summary(Traits::measure(this->value)),
+                  priority(priority) {
+            }
+        };
+
+        Treap() = default;
+        inline ~Treap();
+
+        Treap(const Treap &) = delete;
+        Treap &operator=(const Treap &) = delete;
+
+        inline Treap(Treap &&RHS) noexcept;
+        inline Treap &operator=(Treap &&RHS) noexcept;
+
+    public:
+        inline Node *root() const;
+        inline bool empty() const;
+        inline summary_type summary() const;
+
+        inline Node *first() const;
+        inline Node *last() const;
+        static inline Node *next(const Node *node);
+        static inline Node *prev(const Node *node);
+
+        /// Splits the tree, this tree keeps the leading nodes for which
+        /// <tt>pred(prefix, value)</tt> returns true and the rest is returned. \c prefix is the
+        /// summary of all nodes before the tested one, \a pred must be monotone along the in-order
+        /// sequence.
+        template <class Pred>
+        Treap split(Pred pred);
+
+        /// Appends all nodes of \a other behind the nodes of this tree.
+        inline void append(Treap other);
+
+        /// Inserts a value before the first node for which \a pred returns false, see \c split.
+        template <class Pred>
+        Node *insert(Pred pred, value_type value);
+        inline Node *pushBack(value_type value);
+
+        /// Removes the node and returns its value.
+        value_type erase(Node *node);
+
+        /// Updates the summaries from \a node up to the root, call it after changing a value
+        /// in place without affecting its order.
+        inline void refresh(Node *node);
+
+        inline void clear();
+
+        /// Calls \a func on every value in order.
+        template <class Func>
+        void forEach(Func &&func) const;
+
+    protected:
+        Node *_root = nullptr;
+        uint32_t _seed = 0x9E3779B9u;
+
+        inline uint32_t nextPriority();
+
+        static inline const summary_type &summaryOf(const Node *node);
+        static inline void update(Node *node);
+        static Node *merge(Node *a, Node *b);
+        template <class Pred>
+        static void split(Node *node, Pred &pred, const summary_type &prefix, Node *&left,
+                          Node *&right);
+        static void destroy(Node *node);
+        template <class Func>
+        static void forEach(const Node *node, Func &func);
+    };
+
+    template <class Traits>
+    inline Treap<Traits>::~Treap() {
+        destroy(_root);
+    }
+
+    template <class Traits>
+    inline Treap<Traits>::Treap(Treap &&RHS) noexcept : _root(RHS._root), _seed(RHS._seed) {
+        RHS._root = nullptr;
+    }
+
+    template <class Traits>
+    inline Treap<Traits> &Treap<Traits>::operator=(Treap &&RHS) noexcept {
+        std::swap(_root, RHS._root);
+        std::swap(_seed, RHS._seed);
+        return *this;
+    }
+
+    template <class Traits>
+    inline typename Treap<Traits>::Node *Treap<Traits>::root() const {
+        return _root;
+    }
+
+    template <class Traits>
+    inline bool Treap<Traits>::empty() const {
+        return !_root;
+    }
+
+    template <class Traits>
+    inline typename Treap<Traits>::summary_type Treap<Traits>::summary() const {
+        return summaryOf(_root);
+    }
+
+    template <class Traits>
+    inline typename Treap<Traits>::Node *Treap<Traits>::first() const {
+        auto node = _root;
+        if (node) {
+            while (node->left)
+                node = node->left;
+        }
+        return node;
+    }
+
+    template <class Traits>
+    inline typename Treap<Traits>::Node *Treap<Traits>::last() const {
+        auto node = _root;
+        if (node) {
+            while (node->right)
+                node = node->right;
+        }
+        return node;
+    }
+
+    template <class Traits>
+    inline typename Treap<Traits>::Node *Treap<Traits>::next(const Node *node) {
+        if (node->right) {
+            node = node->right;
+            while (node->left)
+                node = node->left;
+            return const_cast<Node *>(node);
+        }
+        while (node->parent && node->parent->right == node)
+            node = node->parent;
+        return node->parent;
+    }
+
+    template <class Traits>
+    inline typename Treap<Traits>::Node *Treap<Traits>::prev(const Node *node) {
+        if (node->left) {
+            node = node->left;
+            while (node->right)
+                node = node->right;
+            return const_cast<Node *>(node);
+        }
+        while (node->parent && node->parent->left == node)
+            node = node->parent;
+        return node->parent;
+    }
+
+    template <class Traits>
+    template <class Pred>
+    Treap<Traits> Treap<Traits>::split(Pred pred) {
+        Node *left, *right;
+        split(_root, pred, summary_type(), left, right);
+        if (left)
+            left->parent = nullptr;
+        if (right)
+            right->parent = nullptr;
+
+        Treap res;
+        res._root = right;
+        res._seed = nextPriority();
+        _root = left;
+        return res;
+    }
+
+    template <class Traits>
+    inline void Treap<Traits>::append(Treap other) {
+        _root = merge(_root, other._root);
+        if (_root)
+            _root->parent = nullptr;
+        other._root = nullptr;
+    }
+
+    template <class Traits>
+    template <class Pred>
+    typename Treap<Traits>::Node *Treap<Traits>::insert(Pred pred, value_type value) {
+        auto node = new Node(std::move(value), nextPriority());
+        auto right = split(pred);
+        _root = merge(merge(_root, node), right._root);
+        _root->parent = nullptr;
+        right._root = nullptr;
+        return node;
+    }
+
+    template <class Traits>
+    inline typename Treap<Traits>::Node *Treap<Traits>::pushBack(value_type value) {
+        auto node = new Node(std::move(value), nextPriority());
+        _root = merge(_root, node);
+        _root->parent = nullptr;
+        return node;
+    }
+
+    template <class Traits>
+    typename Treap<Traits>::value_type Treap<Traits>::erase(Node *node) {
+        auto parent = node->parent;
+        auto child = merge(node->left, node->right);
+        if (child)
+            child->parent = parent;
+        if (!parent) {
+            _root = child;
+        } else {
+            (parent->left == node ? parent->left : parent->right) = child;
+            refresh(parent);
+        }
+
+        auto value = std::move(node->value);
+        delete node;
+        return value;
+    }
+
+    template <class Traits>
+    inline void Treap<Traits>::refresh(Node *node) {
+        for (; node; node = node->parent) {
+            update(node);
+        }
+    }
+
+    template <class Traits>
+    inline void Treap<Traits>::clear() {
+        destroy(_root);
+        _root = nullptr;
+    }
+
+    template <class Traits>
+    template <class Func>
+    void Treap<Traits>::forEach(Func &&func) const {
+        forEach(_root, func);
+    }
+
+    template <class Traits>
+    inline uint32_t Treap<Traits>::nextPriority() {
+        // xorshift32
+        _seed ^= _seed << 13;
+        _seed ^= _seed >> 17;
+        _seed ^= _seed << 5;
+        return _seed;
+    }
+
+    template <class Traits>
+    inline const typename Treap<Traits>::summary_type &Treap<Traits>::summaryOf(const Node *node) {
+        static const summary_type identity{};
+        return node ? node->summary : identity;
+    }
+
+    template <class Traits>
+    inline void Treap<Traits>::update(Node *node) {
+        node->summary = Traits::combine(
+            Traits::combine(summaryOf(node->left), Traits::measure(node->value)),
+            summaryOf(node->right));
+        if (node->left)
+            node->left->parent = node;
+        if (node->right)
+            node->right->parent = node;
+    }
+
+    template <class Traits>
+    typename Treap<Traits>::Node *Treap<Traits>::merge(Node *a, Node *b) {
+        if (!a)
+            return b;
+        if (!b)
+            return a;
+        if (a->priority > b->priority) {
+            a->right = merge(a->right, b);
+            update(a);
+            return a;
+        }
+        b->left = merge(a, b->left);
+        update(b);
+        return b;
+    }
+
+    template <class Traits>
+    template <class Pred>
+    void Treap<Traits>::split(Node *node, Pred &pred, const summary_type &prefix, Node *&left,
+                              Node *&right) {
+        if (!node) {
+            left = right = nullptr;
+            return;
+        }
+        auto before = Traits::combine(prefix, summaryOf(node->left));
+        if (pred(before, node->value)) {
+            split(node->right, pred, Traits::combine(before, Traits::measure(node->value)),
+                  node->right, right);
+            left = node;
+        } else {
+            split(node->left, pred, prefix, left, node->left);
+            right = node;
+        }
+        update(node);
+    }
+
+    template <class Traits>
+    void Treap<Traits>::destroy(Node *node) {
+        if (!node)
+            return;
+        destroy(node->left);
+        destroy(node->right);
+        delete node;
+    }
+
+    template <class Traits>
+    template <class Func>
+    void Treap<Traits>::forEach(const Node *node, Func &func) {
+        while (node) {
+            forEach(node->left, func);
+            func(node->value);
+            node = node->right;
+        }
+    }
+
+}
+
+#endif // SUBSTATE_TREAP_H
\ No newline at end of file
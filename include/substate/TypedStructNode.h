@@ -0,0 +1,343 @@
+// Copyright (C) 2022-2025 Stdware Collections (https://www.github.com/stdware)
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef SUBSTATE_TYPEDSTRUCTNODE_H
+#define SUBSTATE_TYPEDSTRUCTNODE_H
+
+#include <tuple>
+#include <utility>
+#include <cassert>
+#include <cstring>
+#include <type_traits>
+
+#include <substate/Node.h>
+#include <substate/Action.h>
+#include <substate/ContentHash.h>
+
+namespace ss {
+
+    class TypedStructActionBase;
+
+    template <class S, size_t I>
+    class TypedStructAction;
+
+    /// TypedStructNodeBase - Non-template part of \c TypedStructNode.
+    class SUBSTATE_EXPORT TypedStructNodeBase : public Node {
+    public:
+        inline explicit TypedStructNodeBase(int type);
+        ~TypedStructNodeBase();
+
+    protected:
+        void pushAction(std::unique_ptr<Action> action);
+        void copyIdFrom(const TypedStructNodeBase *src, bool copyId);
+
+        static std::shared_ptr<Node> cloneChild(Node *node, bool copyId);
+
+        friend class TypedStructActionBase;
+    };
+
+    inline TypedStructNodeBase::TypedStructNodeBase(int type) : Node(type) {
+    }
+
+
+    /// TypedStructNode - Struct data structure node whose field types are known at compile time.
+    /// \note The fields are stored unboxed in a tuple, a field of type <tt>std::shared_ptr<T></tt>
+    /// where \c T derives from \c Node holds a child node. The other fields must be hashable by
+    /// \c ContentHasher::addObject.
+    template <class... Fields>
+    class TypedStructNode : public TypedStructNodeBase {
+    public:
+        template <size_t I>
+        using field_type = std::tuple_element_t<I, std::tuple<Fields...>>;
+
+        static constexpr const size_t FieldCount = sizeof...(Fields);
+
+        inline explicit TypedStructNode(int type);
+        ~TypedStructNode();
+
+    public:
+        template <size_t I>
+        inline const field_type<I> &get() const;
+
+        /// Assigns the field, returns false if the value doesn't change.
+        template <size_t I>
+        bool set(field_type<I> value);
+
+        inline int count() const;
+        inline int size() const;
+
+    protected:
+        std::shared_ptr<Node> clone(bool copyId) const override;
+        void collectChildren(std::vector<Node *> &children) const override;
+        void hashContent(ContentHasher &hasher) const override;
+
+        template <class T>
+        struct IsNodePointer : std::false_type {};
+        template <class T>
+        struct IsNodePointer<std::shared_ptr<T>> : std::is_base_of<Node, T> {};
+
+        template <size_t I>
+        static constexpr const bool isNodeField = IsNodePointer<field_type<I>>::value;
+
+        // Floating-point fields are compared by their bits, so that a NaN is the same as itself
+        template <class T>
+        static inline bool isSame(const T &a, const T &b);
+
+        template <size_t... Is>
+        void copyFields(TypedStructNode *dest, bool copyId, std::index_sequence<Is...>) const;
+        template <size_t... Is>
+        void collectFields(std::vector<Node *> &children, std::index_sequence<Is...>) const;
+        template <size_t... Is>
+        void hashFields(ContentHasher &hasher, std::index_sequence<Is...>) const;
+
+        std::tuple<Fields...> _fields;
+
+        template <class S, size_t I>
+        friend class TypedStructAction;
+    };
+
+    template <class... Fields>
+    inline TypedStructNode<Fields...>::TypedStructNode(int type) : TypedStructNodeBase(type) {
+    }
+
+    template <class... Fields>
+    TypedStructNode<Fields...>::~TypedStructNode() {
+        deferChildren();
+    }
+
+    template <class... Fields>
+    template <size_t I>
+    inline const typename TypedStructNode<Fields...>::template field_type<I> &
+        TypedStructNode<Fields...>::get() const {
+        return std::get<I>(_fields);
+    }
+
+    template <class... Fields>
+    template <size_t I>
+    bool TypedStructNode<Fields...>::set(field_type<I> value) {
+        assert(isWritable());
+
+        const auto &field = std::get<I>(_fields);
+
+        // Nothing changes
+        if (isSame(field, value)) {
+            return false;
+        }
+        if constexpr (isNodeField<I>) {
+            assert(!value || value->isFree());
+        }
+
+        auto a = Action::create<TypedStructAction<TypedStructNode, I>>(
+            actionArena(), std::static_pointer_cast<TypedStructNode>(shared_from_this()), field,
+            std::move(value));
+        a->execute(false);
+        pushAction(std::move(a));
+        return true;
+    }
+
+    template <class... Fields>
+    template <class T>
+    inline bool TypedStructNode<Fields...>::isSame(const T &a, const T &b) {
+        if constexpr (std::is_floating_point_v<T>) {
+            return std::memcmp(&a, &b, sizeof(T)) == 0;
+        } else {
+            return a == b;
+        }
+    }
+
+    template <class... Fields>
+    inline int TypedStructNode<Fields...>::count() const {
+        return int(FieldCount);
+    }
+
+    template <class... Fields>
+    inline int TypedStructNode<Fields...>::size() const {
+        return int(FieldCount);
+    }
+
+    template <class... Fields>
+    std::shared_ptr<Node> TypedStructNode<Fields...>::clone(bool copyId) const {
+        auto node = std::make_shared<TypedStructNode>(_type);
+        node->copyIdFrom(this, copyId);
+        copyFields(node.get(), copyId, std::index_sequence_for<Fields...>());
+        return node;
+    }
+
+    template <class... Fields>
+    void TypedStructNode<Fields...>::collectChildren(std::vector<Node *> &children) const {
+        collectFields(children, std::index_sequence_for<Fields...>());
+    }
+
+    template <class... Fields>
+    template <size_t... Is>
+    void TypedStructNode<Fields...>::copyFields(TypedStructNode *dest, bool copyId,
+                                                std::index_sequence<Is...>) const {
+        auto copyField = [this, dest, copyId](auto index) {
+            constexpr size_t I = decltype(index)::value;
+            const auto &field = std::get<I>(_fields);
+            if constexpr (isNodeField<I>) {
+                if (!field) {
+                    return;
+                }
+                // Clone child
+                auto newChild = std::static_pointer_cast<typename field_type<I>::element_type>(
+                    cloneChild(field.get(), copyId));
+                dest->addChild(newChild.get());
+                std::get<I>(dest->_fields) = std::move(newChild);
+            } else {
+                std::get<I>(dest->_fields) = field;
+            }
+        };
+        (copyField(std::integral_constant<size_t, Is>()), ...);
+    }
+
+    template <class... Fields>
+    template <size_t... Is>
+    void TypedStructNode<Fields...>::collectFields(std::vector<Node *> &children,
+                                                   std::index_sequence<Is...>) const {
+        auto collectField = [this, &children](auto index) {
+            constexpr size_t I = decltype(index)::value;
+            if constexpr (isNodeField<I>) {
+                if (auto node = std::get<I>(_fields).get()) {
+                    children.push_back(node);
+                }
+            }
+        };
+        (collectField(std::integral_constant<size_t, Is>()), ...);
+    }
+
+    template <class... Fields>
+    void TypedStructNode<Fields...>::hashContent(ContentHasher &hasher) const {
+        hashFields(hasher, std::index_sequence_for<Fields...>());
+    }
+
+    template <class... Fields>
+    template <size_t... Is>
+    void TypedStructNode<Fields...>::hashFields(ContentHasher &hasher,
+                                                std::index_sequence<Is...>) const {
+        auto hashField = [this, &hasher](auto index) {
+            constexpr size_t I = decltype(index)::value;
+            const auto &field = std::get<I>(_fields);
+            if constexpr (isNodeField<I>) {
+                hasher.add(bool(field));
+            } else {
+                hasher.addObject(field);
+            }
+        };
+        (hashField(std::integral_constant<size_t, Is>()), ...);
+    }
+
+
+    /// TypedStructActionBase - Base action for \c TypedStructNode field assignment, use
+    /// \c index() to tell which \c TypedStructAction it is.
+    class SUBSTATE_EXPORT TypedStructActionBase : public NodeAction {
+    public:
+        inline TypedStructActionBase(const std::shared_ptr<TypedStructNodeBase> &parent,
+                                     int index);
+        ~TypedStructActionBase() = default;
+
+    public:
+        inline int index() const;
+
+    protected:
+        /// Begins the change and sends the pre-notification.
+        void beginChange(bool undo);
+
+        /// Moves the ownership of the changed child if any, sends the notification and ends the
+        /// change.
+        void endChange(bool undo, Node *oldChild, Node *newChild);
+
+        int _index;
+    };
+
+    inline TypedStructActionBase::TypedStructActionBase(
+        const std::shared_ptr<TypedStructNodeBase> &parent, int index)
+        : NodeAction(TypedStructAssign, parent), _index(index) {
+    }
+
+    inline int TypedStructActionBase::index() const {
+        return _index;
+    }
+
+
+    /// TypedStructAction - Action for \c TypedStructNode assignment of field \c I.
+    template <class S, size_t I>
+    class TypedStructAction : public TypedStructActionBase {
+    public:
+        using value_type = typename S::template field_type<I>;
+
+        inline TypedStructAction(const std::shared_ptr<S> &parent, value_type oldValue,
+                                 value_type value);
+        ~TypedStructAction() = default;
+
+    public:
+        void queryNodes(bool inserted,
+                        const std::function<void(const std::shared_ptr<Node> &)> &add) override;
+        void execute(bool undo) override;
+
+    public:
+        inline const value_type &oldValue() const;
+        inline const value_type &value() const;
+
+    protected:
+        value_type _oldValue;
+        value_type _value;
+    };
+
+    template <class S, size_t I>
+    inline TypedStructAction<S, I>::TypedStructAction(const std::shared_ptr<S> &parent,
+                                                      value_type oldValue, value_type value)
+        : TypedStructActionBase(parent, int(I)), _oldValue(std::move(oldValue)),
+          _value(std::move(value)) {
+    }
+
+    template <class S, size_t I>
+    void TypedStructAction<S, I>::queryNodes(
+        bool inserted, const std::function<void(const std::shared_ptr<Node> &)> &add) {
+        if constexpr (S::template isNodeField<I>) {
+            const auto &node = inserted ? _value : _oldValue;
+            if (node) {
+                add(node);
+            }
+        } else {
+            (void) inserted;
+            (void) add;
+        }
+    }
+
+    template <class S, size_t I>
+    void TypedStructAction<S, I>::execute(bool undo) {
+        auto parent = static_cast<S *>(_parent.get());
+
+        const auto &value = undo ? _oldValue : _value;
+        const auto &oldValue = undo ? _value : _oldValue;
+        auto &field = std::get<I>(parent->_fields);
+        assert(S::isSame(field, oldValue));
+
+        beginChange(undo);
+
+        // Do change
+        field = value;
+
+        if constexpr (S::template isNodeField<I>) {
+            endChange(undo, oldValue.get(), value.get());
+        } else {
+            endChange(undo, nullptr, nullptr);
+        }
+    }
+
+    template <class S, size_t I>
+    inline const typename TypedStructAction<S, I>::value_type &
+        TypedStructAction<S, I>::oldValue() const {
+        return _oldValue;
+    }
+
+    template <class S, size_t I>
+    inline const typename TypedStructAction<S, I>::value_type &
+        TypedStructAction<S, I>::value() const {
+        return _value;
+    }
+
+}
+
+#endif // SUBSTATE_TYPEDSTRUCTNODE_H
\ No newline at end of file
@@ -0,0 +1,436 @@
+// Copyright (C) 2022-2025 Stdware Collections (https://www.github.com/stdware)
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef SUBSTATE_VALUE_H
+#define SUBSTATE_VALUE_H
+
+#include <cmath>
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <type_traits>
+
+#include <substate/Node.h>
+#include <substate/Action.h>
+
+namespace ss {
+
+    /// ValueKey - Interned key name, stored and compared as an integer id.
+    /// \note Ids are assigned in the order the names are first seen, which depends on the process,
+    /// so they are only meaningful within the current process. Constructing a key from a name
+    /// interns the name for good, use \c find() to look up a name that may be unknown.
+    class SUBSTATE_EXPORT ValueKey {
+    public:
+        inline ValueKey();
+        explicit ValueKey(const std::string &name);
+        inline explicit ValueKey(const char *name);
+
+        inline int id() const;
+        inline bool isValid() const;
+        const std::string &name() const;
+
+        static inline ValueKey fromId(int id);
+
+        /// Returns the key of \a name without interning it, the key is invalid if the name has
+        /// never been interned.
+        static ValueKey find(const std::string &name);
+
+    public:
+        inline bool operator==(const ValueKey &other) const;
+        inline bool operator!=(const ValueKey &other) const;
+        inline bool operator<(const ValueKey &other) const;
+
+    protected:
+        int _id;
+    };
+
+    inline ValueKey::ValueKey() : _id(-1) {
+    }
+
+    inline ValueKey::ValueKey(const char *name) : ValueKey(std::string(name)) {
+    }
+
+    inline int ValueKey::id() const {
+        return _id;
+    }
+
+    inline bool ValueKey::isValid() const {
+        return _id >= 0;
+    }
+
+    inline ValueKey ValueKey::fromId(int id) {
+        ValueKey key;
+        key._id = id;
+        return key;
+    }
+
+    inline bool ValueKey::operator==(const ValueKey &other) const {
+        return _id == other._id;
+    }
+
+    inline bool ValueKey::operator!=(const ValueKey &other) const {
+        return _id != other._id;
+    }
+
+    inline bool ValueKey::operator<(const ValueKey &other) const {
+        return _id < other._id;
+    }
+
+
+    /// Value - Tagged union of a \c Node or a scalar, the Qt-free counterpart of \c Property.
+    class SUBSTATE_EXPORT Value {
+    public:
+        enum Type {
+            Invalid,
+            Node,
+            Bool,
+            Int,
+            Double,
+            String,
+        };
+
+        inline Value();
+        inline Value(const std::shared_ptr<class Node> &node);
+        /// Stores a \c bool as is, other integers as \c int64_t and floating-point numbers as
+        /// \c double. Pointers are not taken, so they never decay to \c bool.
+        template <class T, class = std::enable_if_t<std::is_arithmetic_v<T>>>
+        inline Value(T value);
+        inline Value(std::string s);
+        inline Value(const char *s);
+        inline ~Value();
+
+        inline Value(const Value &RHS);
+        inline Value(Value &&RHS) noexcept;
+        inline Value &operator=(const Value &RHS);
+        inline Value &operator=(Value &&RHS) noexcept;
+
+        inline Type type() const;
+        inline bool isValid() const;
+        inline bool isNode() const;
+
+        inline std::shared_ptr<class Node> node() const;
+        inline const std::shared_ptr<class Node> &nodeRef() const; // Null if it's not a node
+        inline bool toBool() const;
+        inline int64_t toInt() const;
+        inline double toDouble() const;
+        inline const std::string &toString() const;
+
+    public:
+        inline bool operator==(const Value &other) const;
+        inline bool operator!=(const Value &other) const;
+
+        /// Returns whether the values are identical, like \c operator== except that doubles are
+        /// compared by their bits, so that a NaN is the same as itself and -0.0 differs from 0.0.
+        inline bool isSame(const Value &other) const;
+
+        /// Orders values by type first, then values of the same type by their content. Integers
+        /// and doubles are ordered together by numeric value, an integer before an equal double,
+        /// and NaN after every other number. The order is total and consistent with
+        /// \c operator== except that a NaN is equivalent to another NaN but not equal to it.
+        /// Nodes are ordered by address.
+        inline bool operator<(const Value &other) const;
+
+    protected:
+        union Storage {
+            std::shared_ptr<class Node> node;
+            std::string str;
+            bool b;
+            int64_t i;
+            double d;
+
+            Storage(){};
+            ~Storage(){};
+        };
+        Storage _storage;
+        Type _type;
+
+        inline void construct(const Value &RHS);
+        inline void construct(Value &&RHS);
+        inline void destroy();
+
+        inline bool isNumber() const;
+        static inline bool lessDouble(double a, double b);
+        static inline int compareNumbers(int64_t a, double b);
+    };
+
+    inline Value::Value() : _type(Invalid) {
+    }
+
+    inline Value::Value(const std::shared_ptr<class Node> &node) : _type(Node) {
+        new (&_storage.node) std::shared_ptr<class Node>(node);
+    }
+
+    template <class T, class>
+    inline Value::Value(T value) {
+        if constexpr (std::is_same_v<T, bool>) {
+            _type = Bool;
+            _storage.b = value;
+        } else if constexpr (std::is_floating_point_v<T>) {
+            _type = Double;
+            _storage.d = double(value);
+        } else {
+            _type = Int;
+            _storage.i = int64_t(value);
+        }
+    }
+
+    inline Value::Value(std::string s) : _type(String) {
+        new (&_storage.str) std::string(std::move(s));
+    }
+
+    inline Value::Value(const char *s) : Value(std::string(s)) {
+    }
+
+    inline Value::~Value() {
+        destroy();
+    }
+
+    inline Value::Value(const Value &RHS) : _type(RHS._type) {
+        construct(RHS);
+    }
+
+    inline Value::Value(Value &&RHS) noexcept : _type(RHS._type) {
+        construct(std::move(RHS));
+    }
+
+    inline Value &Value::operator=(const Value &RHS) {
+        if (this != &RHS) {
+            destroy();
+            _type = RHS._type;
+            construct(RHS);
+        }
+        return *this;
+    }
+
+    inline Value &Value::operator=(Value &&RHS) noexcept {
+        if (this != &RHS) {
+            destroy();
+            _type = RHS._type;
+            construct(std::move(RHS));
+        }
+        return *this;
+    }
+
+    inline Value::Type Value::type() const {
+        return _type;
+    }
+
+    inline bool Value::isValid() const {
+        return _type != Invalid;
+    }
+
+    inline bool Value::isNode() const {
+        return _type == Node;
+    }
+
+    inline std::shared_ptr<class Node> Value::node() const {
+        return _type == Node ? _storage.node : std::shared_ptr<class Node>();
+    }
+
+    inline const std::shared_ptr<class Node> &Value::nodeRef() const {
+        static const std::shared_ptr<class Node> null;
+        return _type == Node ? _storage.node : null;
+    }
+
+    inline bool Value::toBool() const {
+        switch (_type) {
+            case Bool:
+                return _storage.b;
+            case Int:
+                return _storage.i != 0;
+            case Double:
+                return _storage.d != 0;
+            default:
+                break;
+        }
+        return false;
+    }
+
+    inline int64_t Value::toInt() const {
+        switch (_type) {
+            case Bool:
+                return _storage.b;
+            case Int:
+                return _storage.i;
+            case Double:
+                return int64_t(_storage.d);
+            default:
+                break;
+        }
+        return 0;
+    }
+
+    inline double Value::toDouble() const {
+        switch (_type) {
+            case Bool:
+                return _storage.b;
+            case Int:
+                return double(_storage.i);
+            case Double:
+                return _storage.d;
+            default:
+                break;
+        }
+        return 0;
+    }
+
+    inline const std::string &Value::toString() const {
+        static const std::string empty;
+        return _type == String ? _storage.str : empty;
+    }
+
+    inline bool Value::operator==(const Value &other) const {
+        if (_type != other._type)
+            return false;
+        switch (_type) {
+            case Node:
+                return _storage.node == other._storage.node;
+            case Bool:
+                return _storage.b == other._storage.b;
+            case Int:
+                return _storage.i == other._storage.i;
+            case Double:
+                return _storage.d == other._storage.d;
+            case String:
+                return _storage.str == other._storage.str;
+            default:
+                break;
+        }
+        return true;
+    }
+
+    inline bool Value::operator!=(const Value &other) const {
+        return !(*this == other);
+    }
+
+    inline bool Value::isSame(const Value &other) const {
+        if (_type == Double && other._type == Double)
+            return std::memcmp(&_storage.d, &other._storage.d, sizeof(double)) == 0;
+        return *this == other;
+    }
+
+    inline bool Value::operator<(const Value &other) const {
+        if (_type != other._type && !(isNumber() && other.isNumber()))
+            return _type < other._type;
+        switch (_type) {
+            case Node:
+                return std::less<>()(_storage.node.get(), other._storage.node.get());
+            case Bool:
+                return _storage.b < other._storage.b;
+            case Int:
+                if (other._type == Double)
+                    return compareNumbers(_storage.i, other._storage.d) <= 0;
+                return _storage.i < other._storage.i;
+            case Double:
+                if (other._type == Int)
+                    return compareNumbers(other._storage.i, _storage.d) > 0;
+                return lessDouble(_storage.d, other._storage.d);
+            case String:
+                return _storage.str < other._storage.str;
+            default:
+                break;
+        }
+        return false;
+    }
+
+    inline void Value::construct(const Value &RHS) {
+        switch (_type) {
+            case Node:
+                new (&_storage.node) std::shared_ptr<class Node>(RHS._storage.node);
+                break;
+            case String:
+                new (&_storage.str) std::string(RHS._storage.str);
+                break;
+            default:
+                std::memcpy(static_cast<void *>(&_storage), &RHS._storage, sizeof(int64_t));
+                break;
+        }
+    }
+
+    inline void Value::construct(Value &&RHS) {
+        switch (_type) {
+            case Node:
+                new (&_storage.node) std::shared_ptr<class Node>(std::move(RHS._storage.node));
+                break;
+            case String:
+                new (&_storage.str) std::string(std::move(RHS._storage.str));
+                break;
+            default:
+                std::memcpy(static_cast<void *>(&_storage), &RHS._storage, sizeof(int64_t));
+                break;
+        }
+    }
+
+    inline bool Value::isNumber() const {
+        return _type == Int || _type == Double;
+    }
+
+    inline bool Value::lessDouble(double a, double b) {
+        // NaN is the greatest
+        return !std::isnan(a) && (std::isnan(b) || a < b);
+    }
+
+    inline int Value::compareNumbers(int64_t a, double b) {
+        // Compare exactly, an integer above 2^53 may not survive the conversion to double
+        if (std::isnan(b) || b >= 9223372036854775808.0)
+            return -1;
+        if (b < -9223372036854775808.0)
+            return 1;
+        auto whole = int64_t(b);
+        if (a != whole)
+            return a < whole ? -1 : 1;
+        double fraction = b - double(whole);
+        return fraction > 0 ? -1 : (fraction < 0 ? 1 : 0);
+    }
+
+    inline void Value::destroy() {
+        switch (_type) {
+            case Node:
+                _storage.node.~shared_ptr();
+                break;
+            case String:
+                _storage.str.~basic_string();
+                break;
+            default:
+                break;
+        }
+    }
+
+
+    /// ValueAction - Action for value change.
+    class SUBSTATE_EXPORT ValueAction : public NodeAction {
+    public:
+        inline ValueAction(Type type, const std::shared_ptr<Node> &parent, Value oldValue,
+                           Value value);
+        ~ValueAction() = default;
+
+    public:
+        void queryNodes(bool inserted,
+                        const std::function<void(const std::shared_ptr<Node> &)> &add) override;
+
+    public:
+        inline const Value &oldValue() const;
+        inline const Value &value() const;
+
+    protected:
+        Value _oldValue;
+        Value _value;
+    };
+
+    inline ValueAction::ValueAction(Type type, const std::shared_ptr<Node> &parent,
+                                    Value oldValue, Value value)
+        : NodeAction(type, parent), _oldValue(std::move(oldValue)), _value(std::move(value)) {
+    }
+
+    inline const Value &ValueAction::oldValue() const {
+        return _oldValue;
+    }
+
+    inline const Value &ValueAction::value() const {
+        return _value;
+    }
+
+}
+
+#endif // SUBSTATE_VALUE_H
\ No newline at end of file
@@ -4,11 +4,15 @@
 #ifndef SUBSTATE_VECTORNODE_H
 #define SUBSTATE_VECTORNODE_H
 
+#include <atomic>
 #include <vector>
+#include <utility>
+#include <algorithm>
 
 #include <substate/Node.h>
 #include <substate/Action.h>
 #include <substate/ArrayView.h>
+#include <substate/NodeView.h>
 
 namespace ss {
 
@@ -16,8 +20,18 @@ namespace ss {
 
     class VectorMoveAction;
 
+    class VectorRemoveRangesAction;
+
+    class VectorMoveRangesAction;
+
     class VectorNodePrivate;
 
+    /// VectorRange - Range of adjacent children of a \c VectorNode.
+    struct VectorRange {
+        int index;
+        int count;
+    };
+
     /// VectorNode - Vector data structure node.
     class SUBSTATE_EXPORT VectorNode : public Node {
     public:
@@ -35,20 +49,44 @@ namespace ss {
         void move(int index, int count, int dest);         // dest: destination index before move
         inline void move2(int index, int count, int dest); // dest: destination index after move
         void remove(int index, int count);
+        void removeRanges(std::vector<VectorRange> ranges); // ranges: ascending and disjoint
+        void moveRanges(std::vector<VectorRange> ranges,
+                        int dest); // dest: destination index before move
         inline std::shared_ptr<Node> at(int index) const;
         inline ArrayView<std::shared_ptr<Node>> data() const;
+
+        /// Returns the child at \a index or the children as borrowed pointers, which is cheaper
+        /// than copying the shared pointers when they're only read.
+        inline Node *nodeAt(int index) const;
+        template <class T = Node>
+        inline NodeView<T> children() const;
+
         inline int count() const;
         inline int size() const;
 
+        /// Returns the index of \a node in this vector, or -1 if it's not a child of this vector.
+        /// \note The positions are cached in the children and only the ones behind the first
+        /// changed index are recalculated, so a batch of queries between two changes costs
+        /// O(n + k) at most. It may be called from several threads at once while the vector isn't
+        /// changed.
+        int indexOf(const Node *node) const;
+
     protected:
         std::shared_ptr<Node> clone(bool copyId) const override;
-        void propagateChildren(const std::function<void(Node *)> &func) override;
+        void collectChildren(std::vector<Node *> &children) const override;
+        void hashContent(ContentHasher &hasher) const override;
+
+        inline void invalidateIndexes(int index);
 
         std::vector<std::shared_ptr<Node>> _vec;
+        // Count of leading children with up-to-date index hint, published after the hints
+        mutable std::atomic<int> _indexed = 0;
 
         friend class VectorNodePrivate;
         friend class VectorInsDelAction;
         friend class VectorMoveAction;
+        friend class VectorRemoveRangesAction;
+        friend class VectorMoveRangesAction;
     };
 
     inline VectorNode::VectorNode(int type) : Node(type) {
@@ -90,6 +128,15 @@ namespace ss {
         return _vec;
     }
 
+    inline Node *VectorNode::nodeAt(int index) const {
+        return _vec.at(index).get();
+    }
+
+    template <class T>
+    inline NodeView<T> VectorNode::children() const {
+        return NodeView<T>(_vec);
+    }
+
     inline int VectorNode::count() const {
         return size();
     }
@@ -98,6 +145,12 @@ namespace ss {
         return int(_vec.size());
     }
 
+    inline void VectorNode::invalidateIndexes(int index) {
+        if (index < _indexed.load(std::memory_order_relaxed)) {
+            _indexed.store(index, std::memory_order_relaxed);
+        }
+    }
+
 
     /// VectorAction - Action for \c VectorNode operations.
     class VectorAction : public NodeAction {
@@ -186,6 +239,106 @@ namespace ss {
         return _children;
     }
 
+
+    /// VectorRangesAction - Action for \c VectorNode operations over multiple ranges.
+    class VectorRangesAction : public NodeAction {
+    public:
+        inline VectorRangesAction(Type type, const std::shared_ptr<VectorNode> &parent,
+                                  std::vector<VectorRange> ranges);
+        ~VectorRangesAction() = default;
+
+    public:
+        inline ArrayView<VectorRange> ranges() const;
+
+        /// Returns the total count of children covered by the ranges.
+        inline int count() const;
+
+    protected:
+        std::vector<VectorRange> _ranges;
+        int _count;
+    };
+
+    inline VectorRangesAction::VectorRangesAction(Type type,
+                                                  const std::shared_ptr<VectorNode> &parent,
+                                                  std::vector<VectorRange> ranges)
+        : NodeAction(type, parent), _ranges(std::move(ranges)), _count(0) {
+        for (const auto &range : std::as_const(_ranges)) {
+            _count += range.count;
+        }
+    }
+
+    inline ArrayView<VectorRange> VectorRangesAction::ranges() const {
+        return _ranges;
+    }
+
+    inline int VectorRangesAction::count() const {
+        return _count;
+    }
+
+
+    /// VectorRemoveRangesAction - Action for \c VectorNode deletion of multiple ranges.
+    class SUBSTATE_EXPORT VectorRemoveRangesAction : public VectorRangesAction {
+    public:
+        inline VectorRemoveRangesAction(const std::shared_ptr<VectorNode> &parent,
+                                        std::vector<VectorRange> ranges,
+                                        std::vector<std::shared_ptr<Node>> children);
+        ~VectorRemoveRangesAction() = default;
+
+    public:
+        void queryNodes(bool inserted,
+                        const std::function<void(const std::shared_ptr<Node> &)> &add) override;
+        void execute(bool undo) override;
+
+    public:
+        /// Returns the removed children of all ranges in order.
+        inline ArrayView<std::shared_ptr<Node>> children() const;
+
+    protected:
+        std::vector<std::shared_ptr<Node>> _children;
+    };
+
+    inline VectorRemoveRangesAction::VectorRemoveRangesAction(
+        const std::shared_ptr<VectorNode> &parent, std::vector<VectorRange> ranges,
+        std::vector<std::shared_ptr<Node>> children)
+        : VectorRangesAction(VectorRemoveRanges, parent, std::move(ranges)),
+          _children(std::move(children)) {
+    }
+
+    inline ArrayView<std::shared_ptr<Node>> VectorRemoveRangesAction::children() const {
+        return _children;
+    }
+
+
+    /// VectorMoveRangesAction - Action for \c VectorNode movement of multiple ranges, the moved
+    /// children are gathered in order at the destination.
+    class SUBSTATE_EXPORT VectorMoveRangesAction : public VectorRangesAction {
+    public:
+        inline VectorMoveRangesAction(const std::shared_ptr<VectorNode> &parent,
+                                      std::vector<VectorRange> ranges, int dest);
+        ~VectorMoveRangesAction() = default;
+
+    public:
+        void queryNodes(bool inserted,
+                        const std::function<void(const std::shared_ptr<Node> &)> &add) override;
+        void execute(bool undo) override;
+
+    public:
+        inline int destination() const;
+
+    protected:
+        int _dest;
+    };
+
+    inline VectorMoveRangesAction::VectorMoveRangesAction(const std::shared_ptr<VectorNode> &parent,
+                                                          std::vector<VectorRange> ranges,
+                                                          int dest)
+        : VectorRangesAction(VectorMoveRanges, parent, std::move(ranges)), _dest(dest) {
+    }
+
+    inline int VectorMoveRangesAction::destination() const {
+        return _dest;
+    }
+
 }
 
 #endif // SUBSTATE_VECTORNODE_H
\ No newline at end of file
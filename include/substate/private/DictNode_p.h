@@ -0,0 +1,18 @@
+// Copyright (C) 2022-2025 Stdware Collections (https://www.github.com/stdware)
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef SUBSTATE_DICTNODE_P_H
+#define SUBSTATE_DICTNODE_P_H
+
+#include <substate/DictNode.h>
+
+namespace ss {
+
+    class SUBSTATE_EXPORT DictNodePrivate {
+    public:
+        static void copy(DictNode *dest, const DictNode *src, bool copyId);
+    };
+
+}
+
+#endif // SUBSTATE_DICTNODE_P_H
\ No newline at end of file
@@ -16,9 +16,19 @@ namespace ss {
 
         /// Sets the root node of the model silently, without creating any actions.
         static inline void setRoot(Model *model, const std::shared_ptr<Node> &node) {
-            node->propagate([model](Node *n) { n->_model = model; });
-            model->_root = node;
-            node->_state = Node::Created;
+            auto &root = model->_root;
+            if (root) {
+                root->_state = Node::Detached;
+            }
+            if (node) {
+                node->traverse([model](Node *n) {
+                    n->_model = model;
+                    n->_chainState.store(0, std::memory_order_relaxed);
+                });
+                node->_state = Node::Active;
+            }
+            root = node;
+            model->_structureEpoch++;
         }
 
         static inline void pushAction(Model *model, std::unique_ptr<Action> action) {
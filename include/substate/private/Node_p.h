@@ -11,23 +11,47 @@ namespace ss {
     class SUBSTATE_EXPORT NodePrivate {
     public:
         /// Call \c Node 's protected \c clone method.
-        static inline std::shared_ptr<Node> clone(Node *node, bool copyId) {
-            return node->clone(copyId);
-        }
-
-        /// Call \c Node 's protected \c propagate method.
-        static inline void propagate(Node *node, const std::function<void(Node *)> &func) {
-            node->propagate(func);
-        }
+        /// \note Past a fixed depth, the rest of the subtree is cloned bottom-up, and the clone
+        /// of a child requested by its container comes from the clones made beforehand, so deep
+        /// trees can't overflow the call stack.
+        static std::shared_ptr<Node> clone(Node *node, bool copyId);
 
         /// Associates the node and all its descendants with a model.
         static void propagate(Node *node, Model *model);
 
+        /// Calls \a func on consecutive subranges covering [0, \a size), the subranges run in
+        /// parallel during a \c Node::parallelClone.
+        static void forRanges(size_t size, const std::function<void(size_t, size_t)> &func);
+
+        /// Turns \a nodes, which outlived the teardown of their model, into free nodes.
+        static void release(std::vector<Node *> &nodes);
+
+        /// Returns whether the node belongs to a subtree that has been removed from the model's
+        /// tree, the node must be managed by a model.
+        /// \note The result is cached on every node up the chain until the structure of the model
+        /// changes, so repeated checks on the same branch take constant time.
+        static bool isChainDetached(const Node *node);
+
+        /// Caches \a detached as the chain state of the subtree of \a node, which has just been
+        /// removed or put back. Large subtrees invalidate the whole model instead.
+        static void setChainDetached(Node *node, bool detached);
+
+        /// Invalidates the cached state of every node in the model.
+        static void invalidateStructure(Model *model);
+
         /// Sets the id of the node silently.
         static inline void setId(Node *node, size_t id) {
             node->_id = id;
         }
 
+        /// Gets or sets the cached position of the node in its parent's container.
+        static inline int indexHint(const Node *node) {
+            return node->_indexHint.load(std::memory_order_relaxed);
+        }
+        static inline void setIndexHint(const Node *node, int index) {
+            node->_indexHint.store(index, std::memory_order_relaxed);
+        }
+
         // Debug use
         static inline bool validateArrayQueryArguments(int index, int size) {
             return index >= 0 && index <= size;
@@ -0,0 +1,18 @@
+// Copyright (C) 2022-2025 Stdware Collections (https://www.github.com/stdware)
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef SUBSTATE_RECORDNODE_P_H
+#define SUBSTATE_RECORDNODE_P_H
+
+#include <substate/RecordNode.h>
+
+namespace ss {
+
+    class SUBSTATE_EXPORT RecordNodeBasePrivate {
+    public:
+        static void copy(RecordNodeBase *dest, const RecordNodeBase *src, bool copyId);
+    };
+
+}
+
+#endif // SUBSTATE_RECORDNODE_P_H
\ No newline at end of file
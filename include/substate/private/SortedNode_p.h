@@ -0,0 +1,18 @@
+// Copyright (C) 2022-2025 Stdware Collections (https://www.github.com/stdware)
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef SUBSTATE_SORTEDNODE_P_H
+#define SUBSTATE_SORTEDNODE_P_H
+
+#include <substate/SortedNode.h>
+
+namespace ss {
+
+    class SUBSTATE_EXPORT SortedNodePrivate {
+    public:
+        static void copy(SortedNode *dest, const SortedNode *src, bool copyId);
+    };
+
+}
+
+#endif // SUBSTATE_SORTEDNODE_P_H
\ No newline at end of file
@@ -0,0 +1,26 @@
+// Copyright (C) 2022-2025 Stdware Collections (https://www.github.com/stdware)
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef SUBSTATE_SPARSEVECTORNODE_P_H
+#define SUBSTATE_SPARSEVECTORNODE_P_H
+
+#include <substate/SparseVectorNode.h>
+
+namespace ss {
+
+    class SUBSTATE_EXPORT SparseVectorNodePrivate {
+    public:
+        static void copy(SparseVectorNode *dest, const SparseVectorNode *src, bool copyId);
+
+        /// Splits the tree at \a index, the returned tree holds the children from \a index on.
+        /// The empty slots between the kept children and \a index are counted in \a gap.
+        static SparseVectorView::Tree splitAt(SparseVectorView::Tree &tree, int index, int &gap);
+
+        /// Appends \a right behind \a gap empty slots, returns the slots left over if \a right
+        /// has no children.
+        static int join(SparseVectorView::Tree &tree, int gap, SparseVectorView::Tree right);
+    };
+
+}
+
+#endif // SUBSTATE_SPARSEVECTORNODE_P_H
\ No newline at end of file
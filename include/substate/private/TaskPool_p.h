@@ -0,0 +1,103 @@
+// Copyright (C) 2022-2025 Stdware Collections (https://www.github.com/stdware)
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef SUBSTATE_TASKPOOL_P_H
+#define SUBSTATE_TASKPOOL_P_H
+
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <memory>
+#include <exception>
+#include <functional>
+#include <condition_variable>
+
+#include <substate/substate_global.h>
+
+namespace ss {
+
+    class TaskGroup;
+
+    /// TaskPool - Work-stealing thread pool for fork-join jobs.
+    /// \note Every worker owns a deque, it pushes and pops its own tasks at the back while idle
+    /// workers steal from the front of the others. The thread that creates the pool is worker 0,
+    /// it runs tasks while it waits for a \c TaskGroup.
+    class SUBSTATE_EXPORT TaskPool {
+    public:
+        explicit TaskPool(int threads);
+        ~TaskPool();
+
+        TaskPool(const TaskPool &) = delete;
+        TaskPool &operator=(const TaskPool &) = delete;
+
+    public:
+        inline int threadCount() const;
+
+        /// Returns the pool the current thread works for, or null.
+        static TaskPool *current();
+
+    protected:
+        struct Task {
+            std::function<void()> func;
+            TaskGroup *group;
+        };
+
+        struct Queue {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+        };
+
+        void push(Task task);
+        bool pop(Task &task);
+        void run(Task &task);
+        void work();
+
+        std::vector<std::unique_ptr<Queue>> _queues;
+        std::vector<std::thread> _threads;
+
+        std::mutex _mutex;
+        std::condition_variable _cv;
+        std::atomic<int> _pending{0};
+        bool _stop = false;
+
+        TaskPool *_previous;
+        int _previousIndex;
+
+        friend class TaskGroup;
+    };
+
+    inline int TaskPool::threadCount() const {
+        return int(_queues.size());
+    }
+
+
+    /// TaskGroup - Set of tasks spawned on a pool and joined together.
+    class SUBSTATE_EXPORT TaskGroup {
+    public:
+        explicit TaskGroup(TaskPool *pool);
+        ~TaskGroup();
+
+        TaskGroup(const TaskGroup &) = delete;
+        TaskGroup &operator=(const TaskGroup &) = delete;
+
+    public:
+        void spawn(std::function<void()> func);
+
+        /// Runs pending tasks until all tasks of the group are done, rethrows the first exception
+        /// thrown by a task.
+        void wait();
+
+    protected:
+        TaskPool *_pool;
+        std::atomic<int> _count{0};
+        std::mutex _mutex;
+        std::exception_ptr _exception;
+
+        friend class TaskPool;
+    };
+
+}
+
+#endif // SUBSTATE_TASKPOOL_P_H
\ No newline at end of file
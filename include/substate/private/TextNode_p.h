@@ -0,0 +1,18 @@
+// Copyright (C) 2022-2025 Stdware Collections (https://www.github.com/stdware)
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef SUBSTATE_TEXTNODE_P_H
+#define SUBSTATE_TEXTNODE_P_H
+
+#include <substate/TextNode.h>
+
+namespace ss {
+
+    class SUBSTATE_EXPORT TextNodePrivate {
+    public:
+        static void copy(TextNode *dest, const TextNode *src, bool copyId);
+    };
+
+}
+
+#endif // SUBSTATE_TEXTNODE_P_H
\ No newline at end of file
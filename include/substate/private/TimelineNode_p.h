@@ -0,0 +1,18 @@
+// Copyright (C) 2022-2025 Stdware Collections (https://www.github.com/stdware)
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef SUBSTATE_TIMELINENODE_P_H
+#define SUBSTATE_TIMELINENODE_P_H
+
+#include <substate/TimelineNode.h>
+
+namespace ss {
+
+    class SUBSTATE_EXPORT TimelineNodePrivate {
+    public:
+        static void copy(TimelineNode *dest, const TimelineNode *src, bool copyId);
+    };
+
+}
+
+#endif // SUBSTATE_TIMELINENODE_P_H
\ No newline at end of file
@@ -2,7 +2,9 @@
 #include "MappingNode_p.h"
 
 #include <cassert>
+#include <numeric>
 
+#include <substate/ContentHash.h>
 #include <substate/private/Model_p.h>
 #include <substate/private/Node_p.h>
 
@@ -12,94 +14,200 @@ namespace ss {
         if (copyId) {
             dest->_id = src->_id;
         }
-        // Clone children
-        for (auto &pair : src->_map) {
-            const auto &key = pair.first;
-            const auto &prop = pair.second;
+        // Clone children, the source is already sorted
+        dest->_entries.reserve(src->_entries.size());
+        for (const auto &entry : src->_entries) {
+            const auto &key = entry.first;
+            const auto &prop = entry.second;
 
             if (prop.isVariant()) {
-                dest->_map.insert(std::make_pair(key, prop.variant()));
+                dest->_entries.emplace_back(key, prop);
                 continue;
             }
 
-            auto newChild = NodePrivate::clone(prop.node().get(), copyId);
+            auto newChild = NodePrivate::clone(prop.nodeRef().get(), copyId);
             dest->addChild(newChild.get());
-            dest->_map.insert(std::make_pair(key, newChild));
+            dest->_entries.emplace_back(key, newChild);
         }
     }
 
-    MappingNode::~MappingNode() = default;
+    MappingNode::~MappingNode() {
+        deferChildren();
+    }
 
-    bool MappingNode::setProperty(const QString &key, const Property &value) {
+    bool MappingNode::setProperty(const PropertyKey &key, const Property &value) {
         assert(isWritable());
+        assert(key.isValid());
 
         Property oldProp;
-        auto it = _map.find(key);
-        if (it == _map.end()) {
+        auto it = lowerBound(key);
+        if (it == _entries.end() || it->first != key) {
             // Nothing changes
             if (!value.isValid())
                 return false;
         } else {
             // Nothing changes
-            if (value == it->second)
+            if (value.isSame(it->second))
                 return false;
             oldProp = it->second;
         }
+        assert(!value.isNode() || value.nodeRef()->isFree());
 
-        beginAction();
+        auto a = Action::create<MappingAction>(
+            actionArena(), std::static_pointer_cast<MappingNode>(shared_from_this()), key,
+            std::move(oldProp), value);
+        a->execute(false);
+        ModelPrivate::pushAction(_model, std::move(a));
+        return true;
+    }
 
-        auto a = std::make_unique<MappingAction>(
-            std::static_pointer_cast<MappingNode>(shared_from_this()), key, oldProp, value);
+    bool MappingNode::setProperties(ArrayView<Entry> values) {
+        assert(isWritable());
 
-        // Pre-Propagate signal
-        {
-            ActionNotification n(Notification::ActionAboutToTrigger, a.get());
-            notify(&n);
-        }
+        // Sort by key, equal keys keep their order so that the last one can be picked
+        std::vector<size_t> order(values.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&values](size_t i, size_t j) {
+            return values[i].first < values[j].first; //
+        });
 
-        // Do change
-        if (it == _map.end()) {
-            _map.insert(std::make_pair(key, value));
-        } else {
-            if (value.isValid()) {
-                it->second = value;
-            } else {
-                _map.erase(it);
+        std::vector<PropertyKey> keys;
+        std::vector<Property> oldValues;
+        std::vector<Property> newValues;
+        auto it = _entries.cbegin();
+        for (size_t i = 0; i < order.size(); ++i) {
+            const auto &key = values[order[i]].first;
+            const auto &value = values[order[i]].second;
+            assert(key.isValid());
+
+            // Overridden by a later value
+            if (i + 1 < order.size() && values[order[i + 1]].first == key) {
+                continue;
             }
-        }
 
-        if (oldProp.isNode()) {
-            auto oldNode = oldProp.node();
-            removeChild(oldNode.get());
-        }
-        if (value.node()) {
-            auto node = value.node();
-            addChild(node.get());
-        }
+            while (it != _entries.cend() && it->first < key) {
+                ++it;
+            }
+            const auto &oldValue =
+                (it != _entries.cend() && it->first == key) ? it->second : Property();
 
-        // Propagate signal
-        {
-            ActionNotification n(Notification::ActionTriggered, a.get());
-            notify(&n);
+            // Nothing changes
+            if (value.isSame(oldValue)) {
+                continue;
+            }
+            assert(!value.isNode() || value.nodeRef()->isFree());
+
+            keys.push_back(key);
+            oldValues.push_back(oldValue);
+            newValues.push_back(value);
+        }
+        if (keys.empty()) {
+            return false;
         }
 
-        // Push
-        endAction();
+        auto a = Action::create<MappingBatchAction>(
+            actionArena(), std::static_pointer_cast<MappingNode>(shared_from_this()),
+            std::move(keys), std::move(oldValues), std::move(newValues));
+        a->execute(false);
         ModelPrivate::pushAction(_model, std::move(a));
         return true;
     }
 
+    bool MappingNode::setProperties(std::initializer_list<std::pair<QString, Property>> values) {
+        std::vector<Entry> entries;
+        entries.reserve(values.size());
+        for (const auto &value : values) {
+            // Removing a name that has never been interned changes nothing
+            auto key = value.second.isValid() ? PropertyKey(value.first)
+                                              : PropertyKey::find(value.first);
+            if (key.isValid()) {
+                entries.emplace_back(key, value.second);
+            }
+        }
+        return setProperties(ArrayView<Entry>(entries));
+    }
+
     std::shared_ptr<Node> MappingNode::clone(bool copyId) const {
         auto node = std::make_shared<MappingNode>(_type);
         MappingNodePrivate::copy(node.get(), this, copyId);
         return node;
     }
 
-    void MappingNode::propagateChildren(const std::function<void(Node *)> &func) {
-        for (const auto &pair : std::as_const(_map)) {
-            const auto &prop = pair.second;
+    void MappingNode::collectChildren(std::vector<Node *> &children) const {
+        for (const auto &entry : std::as_const(_entries)) {
+            const auto &prop = entry.second;
             if (prop.isNode()) {
-                NodePrivate::propagate(prop.node().get(), func);
+                children.push_back(prop.nodeRef().get());
+            }
+        }
+    }
+
+    void MappingNode::hashContent(ContentHasher &hasher) const {
+        hasher.add(uint64_t(_entries.size()));
+        for (const auto &entry : std::as_const(_entries)) {
+            auto name = entry.first.name();
+            hasher.add(uint64_t(name.size()));
+            hasher.write(name.utf16(), size_t(name.size()) * sizeof(char16_t));
+            entry.second.hashContent(hasher);
+        }
+    }
+
+    void MappingNode::assign(const PropertyKey &key, const Property &value) {
+        auto it = _entries.begin() + (lowerBound(key) - _entries.cbegin());
+        if (it == _entries.end() || it->first != key) {
+            _entries.insert(it, std::make_pair(key, value));
+        } else {
+            if (value.isValid()) {
+                it->second = value;
+            } else {
+                _entries.erase(it);
+            }
+        }
+    }
+
+    void MappingNode::assign(ArrayView<PropertyKey> keys, ArrayView<Property> values) {
+        // Replace or clear the existing keys in place and count the new ones
+        size_t inserted = 0;
+        bool erased = false;
+        auto it = _entries.begin();
+        for (size_t i = 0; i < keys.size(); ++i) {
+            const auto &key = keys[i];
+            while (it != _entries.end() && it->first < key) {
+                ++it;
+            }
+            if (it != _entries.end() && it->first == key) {
+                it->second = values[i];
+                erased |= !values[i].isValid();
+            } else if (values[i].isValid()) {
+                inserted++;
+            }
+        }
+        if (erased) {
+            _entries.erase(std::remove_if(_entries.begin(), _entries.end(),
+                                          [](const Entry &entry) {
+                                              return !entry.second.isValid(); //
+                                          }),
+                           _entries.end());
+        }
+        if (inserted == 0) {
+            return;
+        }
+
+        // Merge the new keys from the back, which reuses the capacity left by a previous removal
+        size_t r = _entries.size();
+        _entries.resize(r + inserted);
+        size_t w = _entries.size();
+        for (size_t i = keys.size(); i-- > 0;) {
+            const auto &key = keys[i];
+            while (r > 0 && key < _entries[r - 1].first) {
+                _entries[--w] = std::move(_entries[--r]);
+            }
+            // Already assigned in place
+            if (r > 0 && _entries[r - 1].first == key) {
+                continue;
+            }
+            if (values[i].isValid()) {
+                _entries[--w] = std::make_pair(key, values[i]);
             }
         }
     }
@@ -111,51 +219,76 @@ namespace ss {
 
         auto &key = _key;
         auto &value = undo ? _oldValue : _value;
-        auto &map = parent->_map;
-        Property oldProp;
+        auto &oldProp = undo ? _value : _oldValue;
+        assert(parent->property(key).isSame(oldProp));
 
         parent->beginAction();
 
-        auto it = map.find(key);
-        if (it == map.end()) {
-            assert(value.isValid());
-        } else {
-            assert(value != it->second);
-            oldProp = it->second;
+        // Pre-Propagate signal
+        {
+            ActionNotification n(Notification::ActionAboutToTrigger, this, undo);
+            parent->notify(&n);
         }
 
-        MappingAction a(std::static_pointer_cast<MappingNode>(parent->shared_from_this()), key,
-                        oldProp, value);
+        // Do change
+        parent->assign(key, value);
 
-        // Pre-Propagate signal
+        if (oldProp.isNode()) {
+            parent->removeChild(oldProp.nodeRef().get());
+        }
+        if (value.nodeRef()) {
+            parent->addChild(value.nodeRef().get());
+        }
+
+        // Propagate signal
         {
-            ActionNotification n(Notification::ActionAboutToTrigger, &a);
+            ActionNotification n(Notification::ActionTriggered, this, undo);
             parent->notify(&n);
         }
 
-        // Do change
-        if (it == map.end()) {
-            map.insert(std::make_pair(key, value));
-        } else {
-            if (value.isValid()) {
-                it->second = value;
-            } else {
-                map.erase(it);
+        parent->endAction();
+    }
+
+    MappingBatchAction::~MappingBatchAction() = default;
+
+    void MappingBatchAction::queryNodes(
+        bool inserted, const std::function<void(const std::shared_ptr<Node> &)> &add) {
+        for (const auto &value : inserted ? _values : _oldValues) {
+            if (value.isNode()) {
+                add(value.nodeRef());
             }
         }
+    }
 
-        if (oldProp.isNode()) {
-            auto oldNode = oldProp.node();
-            parent->removeChild(oldNode.get());
+    void MappingBatchAction::execute(bool undo) {
+        auto parent = static_cast<MappingNode *>(_parent.get());
+
+        auto &values = undo ? _oldValues : _values;
+        auto &oldValues = undo ? _values : _oldValues;
+
+        parent->beginAction();
+
+        // Pre-Propagate signal
+        {
+            ActionNotification n(Notification::ActionAboutToTrigger, this, undo);
+            parent->notify(&n);
         }
-        if (value.node()) {
-            auto node = value.node();
-            parent->addChild(node.get());
+
+        // Do change
+        parent->assign(_keys, values);
+
+        for (size_t i = 0; i < _keys.size(); ++i) {
+            if (oldValues[i].isNode()) {
+                parent->removeChild(oldValues[i].nodeRef().get());
+            }
+            if (values[i].isNode()) {
+                parent->addChild(values[i].nodeRef().get());
+            }
         }
 
         // Propagate signal
         {
-            ActionNotification n(Notification::ActionTriggered, &a);
+            ActionNotification n(Notification::ActionTriggered, this, undo);
             parent->notify(&n);
         }
 
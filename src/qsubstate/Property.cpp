@@ -1,13 +1,124 @@
 #include "Property.h"
 
+#include <QtCore/QByteArray>
+#include <QtCore/QDataStream>
+
+#include <substate/KeyTable.h>
+#include <substate/ContentHash.h>
+
 namespace ss {
 
-    Property::Property(const Property &RHS) : _type(RHS._type) {
-        switch (_type) {
-            case Node:
+    struct QStringHash {
+        inline size_t operator()(const QString &s) const {
+            return qHash(s);
+        }
+    };
+
+    static KeyTable<QString, QStringHash> &keyTable() {
+        static KeyTable<QString, QStringHash> table;
+        return table;
+    }
+
+    PropertyKey::PropertyKey(const QString &name) : _id(keyTable().intern(name)) {
+    }
+
+    PropertyKey PropertyKey::find(const QString &name) {
+        return fromId(keyTable().find(name));
+    }
+
+    QString PropertyKey::name() const {
+        return _id < 0 ? QString() : keyTable().key(_id);
+    }
+
+    Property::Property(const QVariant &variant) : _kind(VariantKind), _length(0) {
+        switch (variant.userType()) {
+            case QMetaType::Bool:
+                _kind = BoolKind;
+                _storage.b = variant.toBool();
+                return;
+            case QMetaType::Int:
+                _kind = IntKind;
+                _storage.i = variant.toInt();
+                return;
+            case QMetaType::Double:
+                _kind = DoubleKind;
+                _storage.d = variant.toDouble();
+                return;
+            case QMetaType::QString:
+                initString(variant.toString());
+                return;
+            default:
+                break;
+        }
+        new (&_storage.var) QVariant(variant);
+    }
+
+    Property::Property(const QString &s) : _kind(InvalidKind), _length(0) {
+        initString(s);
+    }
+
+    QVariant Property::variant() const {
+        switch (_kind) {
+            case VariantKind:
+                return _storage.var;
+            case BoolKind:
+                return QVariant(_storage.b);
+            case IntKind:
+                return QVariant(_storage.i);
+            case DoubleKind:
+                return QVariant(_storage.d);
+            case StringKind:
+                return QVariant(toString());
+            default:
+                break;
+        }
+        return QVariant();
+    }
+
+    QString Property::toString() const {
+        if (_kind == StringKind) {
+            return QString(reinterpret_cast<const QChar *>(_storage.str), _length);
+        }
+        return variant().toString();
+    }
+
+    void Property::hashContent(ContentHasher &hasher) const {
+        hasher.add(int(type()));
+        if (_kind < VariantKind) {
+            return;
+        }
+
+        // The inline kinds are hashed as the variants they stand for
+        QByteArray bytes;
+        {
+            QDataStream out(&bytes, QIODevice::WriteOnly);
+            out << variant();
+        }
+        hasher.add(uint64_t(bytes.size()));
+        hasher.write(bytes.constData(), size_t(bytes.size()));
+    }
+
+    void Property::initString(const QString &s) {
+        int size = s.size();
+        if (size > ShortStringCapacity) {
+            _kind = VariantKind;
+            new (&_storage.var) QVariant(s);
+            return;
+        }
+        _kind = StringKind;
+        _length = uint8_t(size);
+        auto data = s.constData();
+        for (int i = 0; i < size; ++i) {
+            _storage.str[i] = char16_t(data[i].unicode());
+        }
+    }
+
+    void Property::copy(const Property &RHS) {
+        switch (_kind) {
+            case NodeKind:
                 new (&_storage.node) std::shared_ptr<class Node>(RHS._storage.node);
                 break;
-            case Variant:
+            case VariantKind:
                 new (&_storage.var) QVariant(RHS._storage.var);
                 break;
             default:
@@ -15,12 +126,12 @@ namespace ss {
         }
     }
 
-    Property::Property(Property &&RHS) : _type(RHS._type) {
-        switch (_type) {
-            case Node:
+    void Property::move(Property &&RHS) {
+        switch (_kind) {
+            case NodeKind:
                 new (&_storage.node) std::shared_ptr<class Node>(std::move(RHS._storage.node));
                 break;
-            case Variant:
+            case VariantKind:
                 new (&_storage.var) QVariant(std::move(RHS._storage.var));
                 break;
             default:
@@ -28,66 +139,12 @@ namespace ss {
         }
     }
 
-    Property &Property::operator=(const Property &RHS) {
-        if (this != &RHS) {
-            switch (_type) {
-                case Node:
-                    _storage.node.~shared_ptr();
-                    break;
-                case Variant:
-                    _storage.var.~QVariant();
-                    break;
-                default:
-                    break;
-            }
-            _type = RHS._type;
-            switch (_type) {
-                case Node:
-                    new (&_storage.node) std::shared_ptr<class Node>(RHS._storage.node);
-                    break;
-                case Variant:
-                    new (&_storage.var) QVariant(RHS._storage.var);
-                    break;
-                default:
-                    break;
-            }
-        }
-        return *this;
-    }
-
-    Property &Property::operator=(Property &&RHS) {
-        if (this != &RHS) {
-            switch (_type) {
-                case Node:
-                    _storage.node.~shared_ptr();
-                    break;
-                case Variant:
-                    _storage.var.~QVariant();
-                    break;
-                default:
-                    break;
-            }
-            _type = RHS._type;
-            switch (_type) {
-                case Node:
-                    new (&_storage.node) std::shared_ptr<class Node>(std::move(RHS._storage.node));
-                    break;
-                case Variant:
-                    new (&_storage.var) QVariant(std::move(RHS._storage.var));
-                    break;
-                default:
-                    break;
-            }
-        }
-        return *this;
-    }
-
-    Property::~Property() {
-        switch (_type) {
-            case Node:
+    void Property::destroy() {
+        switch (_kind) {
+            case NodeKind:
                 _storage.node.~shared_ptr();
                 break;
-            case Variant:
+            case VariantKind:
                 _storage.var.~QVariant();
                 break;
             default:
@@ -95,14 +152,16 @@ namespace ss {
         }
     }
 
-    bool Property::operator==(const Property &other) const {
-        if (_type != other._type)
-            return false;
-        switch (_type) {
-            case Node:
+    bool Property::equals(const Property &other) const {
+        switch (_kind) {
+            case NodeKind:
                 return _storage.node == other._storage.node;
-            case Variant:
+            case VariantKind:
                 return _storage.var == other._storage.var;
+            case StringKind:
+                return _length == other._length &&
+                       std::memcmp(_storage.str, other._storage.str,
+                                   _length * sizeof(char16_t)) == 0;
             default:
                 break;
         }
@@ -112,12 +171,12 @@ namespace ss {
     void PropertyAction::queryNodes(bool inserted,
                                     const std::function<void(const std::shared_ptr<Node> &)> &add) {
         if (inserted) {
-            if (_oldValue.isNode()) {
-                add(_oldValue.node());
+            if (_value.isNode()) {
+                add(_value.nodeRef());
             }
         } else {
-            if (_value.isNode()) {
-                add(_value.node());
+            if (_oldValue.isNode()) {
+                add(_oldValue.nodeRef());
             }
         }
     }
@@ -1,6 +1,11 @@
 #include "StructNode.h"
 #include "StructNode_p.h"
 
+#include <cassert>
+#include <numeric>
+#include <algorithm>
+
+#include <substate/ContentHash.h>
 #include <substate/private/Node_p.h>
 #include <substate/private/Model_p.h>
 
@@ -20,7 +25,7 @@ namespace ss {
                 continue;
             }
 
-            auto newChild = NodePrivate::clone(prop.node().get(), copyId);
+            auto newChild = NodePrivate::clone(prop.nodeRef().get(), copyId);
             dest->addChild(newChild.get());
             dest->_storage[i] = newChild;
         }
@@ -30,24 +35,100 @@ namespace ss {
 
     void StructNodeBase::setAt(int index, Property value) {
         assert(isWritable());
-        assert(index >= 0 && index < _storage.size());
+        assert(index >= 0 && size_t(index) < _size);
 
-        auto action = std::make_unique<StructAction>(
-            std::static_pointer_cast<StructNodeBase>(shared_from_this()), index, _storage[index],
-            std::move(value));
+        auto action = Action::create<StructAction>(
+            actionArena(), std::static_pointer_cast<StructNodeBase>(shared_from_this()), index,
+            _storage[index], std::move(value));
         action->execute(false);
         ModelPrivate::pushAction(_model, std::move(action));
     }
 
-    void StructNodeBase::propagateChildren(const std::function<void(Node *)> &func) {
+    void StructNodeBase::setAt(int index, ArrayView<Property> values) {
+        assert(index >= 0 && size_t(index) + values.size() <= _size);
+
+        std::vector<int> indexes;
+        std::vector<Property> newValues;
+        indexes.reserve(values.size());
+        newValues.reserve(values.size());
+        for (size_t i = 0; i < values.size(); ++i) {
+            indexes.push_back(index + int(i));
+            newValues.push_back(values[i]);
+        }
+        setMany(std::move(indexes), std::move(newValues));
+    }
+
+    void StructNodeBase::setAt(ArrayView<std::pair<int, Property>> values) {
+        // Sort by index, equal indexes keep their order so that the last one can be picked
+        std::vector<size_t> order(values.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&values](size_t i, size_t j) {
+            return values[i].first < values[j].first; //
+        });
+
+        std::vector<int> indexes;
+        std::vector<Property> newValues;
+        for (size_t i = 0; i < order.size(); ++i) {
+            const auto &pair = values[order[i]];
+            assert(pair.first >= 0 && size_t(pair.first) < _size);
+
+            // Overridden by a later value
+            if (i + 1 < order.size() && values[order[i + 1]].first == pair.first) {
+                continue;
+            }
+            indexes.push_back(pair.first);
+            newValues.push_back(pair.second);
+        }
+        setMany(std::move(indexes), std::move(newValues));
+    }
+
+    void StructNodeBase::setMany(std::vector<int> indexes, std::vector<Property> values) {
+        assert(isWritable());
+
+        // Drop the fields that don't change
+        std::vector<Property> oldValues;
+        size_t count = 0;
+        for (size_t i = 0; i < indexes.size(); ++i) {
+            const auto &oldValue = _storage[indexes[i]];
+            if (values[i].isSame(oldValue)) {
+                continue;
+            }
+            assert(!values[i].isNode() || values[i].nodeRef()->isFree());
+
+            indexes[count] = indexes[i];
+            values[count] = std::move(values[i]);
+            oldValues.push_back(oldValue);
+            count++;
+        }
+        if (count == 0) {
+            return;
+        }
+        indexes.resize(count);
+        values.resize(count);
+
+        auto a = Action::create<StructBatchAction>(
+            actionArena(), std::static_pointer_cast<StructNodeBase>(shared_from_this()),
+            std::move(indexes), std::move(oldValues), std::move(values));
+        a->execute(false);
+        ModelPrivate::pushAction(_model, std::move(a));
+    }
+
+    void StructNodeBase::collectChildren(std::vector<Node *> &children) const {
         for (size_t i = 0; i < _size; ++i) {
             const auto &prop = _storage[i];
             if (prop.isNode()) {
-                NodePrivate::propagate(prop.node().get(), func);
+                children.push_back(prop.nodeRef().get());
             }
         }
     }
 
+    void StructNodeBase::hashContent(ContentHasher &hasher) const {
+        hasher.add(uint64_t(_size));
+        for (size_t i = 0; i < _size; ++i) {
+            _storage[i].hashContent(hasher);
+        }
+    }
+
     void StructNodeBase::copy(StructNodeBase *dest, const StructNodeBase *src, bool copyId) {
         StructNodeBasePrivate::copy(dest, src, copyId);
     }
@@ -59,35 +140,78 @@ namespace ss {
 
         auto &index = _index;
         auto &value = undo ? _oldValue : _value;
+        auto &oldValue = undo ? _value : _oldValue;
         auto &storage = parent->_storage;
-        Property oldProp = storage[index];
+        assert(storage[index].isSame(oldValue));
 
         parent->beginAction();
 
-        StructAction a(std::static_pointer_cast<StructNodeBase>(parent->shared_from_this()), index,
-                       oldProp, value);
-
         // Pre-Propagate signal
         {
-            ActionNotification n(Notification::ActionAboutToTrigger, &a);
+            ActionNotification n(Notification::ActionAboutToTrigger, this, undo);
             parent->notify(&n);
         }
 
         // Do change
         storage[index] = value;
 
-        if (oldProp.isNode()) {
-            auto oldNode = oldProp.node();
-            parent->removeChild(oldNode.get());
+        if (oldValue.isNode()) {
+            parent->removeChild(oldValue.nodeRef().get());
+        }
+        if (value.nodeRef()) {
+            parent->addChild(value.nodeRef().get());
+        }
+
+        // Propagate signal
+        {
+            ActionNotification n(Notification::ActionTriggered, this, undo);
+            parent->notify(&n);
+        }
+
+        parent->endAction();
+    }
+
+    StructBatchAction::~StructBatchAction() = default;
+
+    void StructBatchAction::queryNodes(
+        bool inserted, const std::function<void(const std::shared_ptr<Node> &)> &add) {
+        for (const auto &value : inserted ? _values : _oldValues) {
+            if (value.isNode()) {
+                add(value.nodeRef());
+            }
         }
-        if (value.node()) {
-            auto node = value.node();
-            parent->addChild(node.get());
+    }
+
+    void StructBatchAction::execute(bool undo) {
+        auto parent = static_cast<StructNodeBase *>(_parent.get());
+
+        auto &values = undo ? _oldValues : _values;
+        auto &oldValues = undo ? _values : _oldValues;
+        auto &storage = parent->_storage;
+
+        parent->beginAction();
+
+        // Pre-Propagate signal
+        {
+            ActionNotification n(Notification::ActionAboutToTrigger, this, undo);
+            parent->notify(&n);
+        }
+
+        // Do change
+        for (size_t i = 0; i < _indexes.size(); ++i) {
+            storage[_indexes[i]] = values[i];
+
+            if (oldValues[i].isNode()) {
+                parent->removeChild(oldValues[i].nodeRef().get());
+            }
+            if (values[i].isNode()) {
+                parent->addChild(values[i].nodeRef().get());
+            }
         }
 
         // Propagate signal
         {
-            ActionNotification n(Notification::ActionTriggered, &a);
+            ActionNotification n(Notification::ActionTriggered, this, undo);
             parent->notify(&n);
         }
 
@@ -4,6 +4,37 @@
 
 namespace ss {
 
+    // Each action is prefixed with the arena it's allocated in, or null for the global heap
+    static constexpr const size_t HeaderSize = MemoryPool::Alignment;
+
+    void *Action::operator new(size_t size) {
+        return operator new(size, nullptr);
+    }
+
+    void *Action::operator new(size_t size, ActionArena *arena) {
+        auto ptr = static_cast<char *>(arena ? arena->allocate(HeaderSize + size)
+                                             : ::operator new(HeaderSize + size));
+        *reinterpret_cast<ActionArena **>(ptr) = arena;
+        return ptr + HeaderSize;
+    }
+
+    void Action::operator delete(void *ptr) {
+        if (!ptr) {
+            return;
+        }
+        auto base = static_cast<char *>(ptr) - HeaderSize;
+        if (auto arena = *reinterpret_cast<ActionArena **>(base)) {
+            arena->release();
+        } else {
+            ::operator delete(base);
+        }
+    }
+
+    void Action::operator delete(void *ptr, ActionArena *arena) {
+        (void) arena;
+        operator delete(ptr);
+    }
+
     void RootChangeAction::queryNodes(
         bool inserted, const std::function<void(const std::shared_ptr<Node> &)> &add) {
         if (inserted) {
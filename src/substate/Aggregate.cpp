@@ -0,0 +1,87 @@
+#include "Aggregate.h"
+
+#include <atomic>
+#include <utility>
+#include <algorithm>
+
+#include "Model.h"
+
+namespace ss {
+
+    // Serials are never reused, so the stale records of a destroyed aggregate are never matched
+    static std::atomic<size_t> nextSerial{1};
+
+    AggregateBase::AggregateBase(Model *model) : _model(model), _serial(nextSerial++) {
+        assert(model);
+        model->_aggregates.push_back(this);
+    }
+
+    AggregateBase::~AggregateBase() {
+        if (!_model) {
+            return;
+        }
+
+        auto &aggregates = _model->_aggregates;
+        aggregates.erase(std::find(aggregates.begin(), aggregates.end(), this));
+
+        // Free the records on the document, the removed nodes free theirs when they die
+        if (auto root = _model->root()) {
+            root->traverse([this](Node *node) {
+                for (auto link = &node->_aggregates; *link; link = &(*link)->next) {
+                    if ((*link)->serial == _serial) {
+                        auto rec = *link;
+                        *link = rec->next;
+                        delete rec;
+                        break;
+                    }
+                }
+            });
+        }
+    }
+
+    void AggregateBase::invalidate(const Node *node) {
+        // A stale node has no valid ancestor, so the walk stops at the first one
+        for (auto p = node; p; p = p->_parent) {
+            auto rec = record(p);
+            if (!rec || !rec->valid) {
+                break;
+            }
+            rec->valid = false;
+        }
+    }
+
+    AggregateRecord *AggregateBase::record(const Node *node) const {
+        for (auto rec = node->_aggregates; rec; rec = rec->next) {
+            if (rec->serial == _serial) {
+                return rec;
+            }
+        }
+        return nullptr;
+    }
+
+    void AggregateBase::attach(const Node *node, AggregateRecord *record) {
+        record->serial = _serial;
+        record->next = node->_aggregates;
+        node->_aggregates = record;
+    }
+
+    void AggregateBase::collectStale(const Node *node, std::vector<const Node *> &nodes) const {
+        std::vector<Node *> children;
+        nodes.push_back(node);
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            children.clear();
+            nodes[i]->collectChildren(children);
+            for (const auto &child : std::as_const(children)) {
+                auto rec = record(child);
+                if (!rec || !rec->valid) {
+                    nodes.push_back(child);
+                }
+            }
+        }
+    }
+
+    void AggregateBase::collectChildren(const Node *node, std::vector<Node *> &children) {
+        node->collectChildren(children);
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,47 @@
+#include "ArrayNode.h"
+
+#include "Model_p.h"
+
+namespace ss {
+
+    ArrayNodeBase::~ArrayNodeBase() = default;
+
+    void ArrayNodeBase::pushAction(std::unique_ptr<Action> action) {
+        ModelPrivate::pushAction(_model, std::move(action));
+    }
+
+    void ArrayNodeBase::copyIdFrom(const ArrayNodeBase *src, bool copyId) {
+        if (copyId) {
+            _id = src->_id;
+        }
+    }
+
+    void ArrayActionBase::queryNodes(
+        bool inserted, const std::function<void(const std::shared_ptr<Node> &)> &add) {
+        (void) inserted;
+        (void) add;
+    }
+
+    void ArrayActionBase::beginChange(bool undo) {
+        auto parent = static_cast<ArrayNodeBase *>(_parent.get());
+
+        parent->beginAction();
+        // Pre-Propagate signal
+        {
+            ActionNotification n(Notification::ActionAboutToTrigger, this, undo);
+            parent->notify(&n);
+        }
+    }
+
+    void ArrayActionBase::endChange(bool undo) {
+        auto parent = static_cast<ArrayNodeBase *>(_parent.get());
+
+        // Post-propagate signal
+        {
+            ActionNotification n(Notification::ActionTriggered, this, undo);
+            parent->notify(&n);
+        }
+        parent->endAction();
+    }
+
+}
\ No newline at end of file
@@ -1,15 +1,19 @@
 #include "BytesNode.h"
 #include "BytesNode_p.h"
 
+#include <cassert>
+
 #include "Model_p.h"
+#include "Node_p.h"
+#include "ContentHash.h"
 
 namespace ss {
 
     void BytesNodePrivate::copy(BytesNode *dest, const BytesNode *src, bool copyId) {
-        if (!copyId) {
+        if (copyId) {
             dest->_id = src->_id;
         }
-        // Copy data
+        // Share data, it's copied on the first write of either node
         dest->_data = src->_data;
     }
 
@@ -17,22 +21,23 @@ namespace ss {
 
     void BytesNode::insert(int index, std::vector<char> data) {
         assert(isWritable());
-        assert(NodePrivate::validateArrayQueryArguments(index, _data.size()) && !data.empty());
+        assert(NodePrivate::validateArrayQueryArguments(index, _data->size()) && !data.empty());
 
-        auto action = std::make_unique<BytesAction>(
-            Action::BytesInsert, std::static_pointer_cast<BytesNode>(shared_from_this()), index,
-            std::move(data));
+        auto action = Action::create<BytesAction>(
+            actionArena(), Action::BytesInsert,
+            std::static_pointer_cast<BytesNode>(shared_from_this()), index, std::move(data));
         action->execute(false);
         ModelPrivate::pushAction(_model, std::move(action));
     }
 
     void BytesNode::remove(int index, int size) {
         assert(isWritable());
-        assert(NodePrivate::validateArrayRemoveArguments(index, size, _data.size()));
+        assert(NodePrivate::validateArrayRemoveArguments(index, size, _data->size()));
 
-        auto begin = _data.begin() + index;
-        auto action = std::make_unique<BytesAction>(
-            Action::BytesRemove, std::static_pointer_cast<BytesNode>(shared_from_this()), index,
+        auto begin = _data->begin() + index;
+        auto action = Action::create<BytesAction>(
+            actionArena(), Action::BytesRemove,
+            std::static_pointer_cast<BytesNode>(shared_from_this()), index,
             std::vector<char>(begin, begin + size));
         action->execute(false);
         ModelPrivate::pushAction(_model, std::move(action));
@@ -40,19 +45,18 @@ namespace ss {
 
     void BytesNode::replace(int index, std::vector<char> data) {
         assert(isWritable());
-        auto begin = _data.begin() + index;
-        auto end = begin + data.size();
-        if (auto off = end - _data.end(); off > 0) {
-            auto action = std::make_unique<BytesAction>(
-                Action::BytesInsert, std::static_pointer_cast<BytesNode>(shared_from_this()),
-                int(data.size()), std::vector<char>(off, 0));
-            action->execute(false);
-            ModelPrivate::pushAction(_model, std::move(action));
+        assert(NodePrivate::validateArrayQueryArguments(index, _data->size()) && !data.empty());
+
+        // Grow the array first if the data runs past the end
+        if (int off = index + int(data.size()) - size(); off > 0) {
+            insert(size(), std::vector<char>(off, 0));
         }
 
-        auto action = std::make_unique<BytesReplaceAction>(
-            std::static_pointer_cast<BytesNode>(shared_from_this()), index, std::move(data),
-            std::vector<char>(begin, end));
+        auto begin = _data->begin() + index;
+        std::vector<char> oldBytes(begin, begin + data.size());
+        auto action = Action::create<BytesReplaceAction>(
+            actionArena(), std::static_pointer_cast<BytesNode>(shared_from_this()), index,
+            std::move(data), std::move(oldBytes));
         action->execute(false);
         ModelPrivate::pushAction(_model, std::move(action));
     }
@@ -63,6 +67,11 @@ namespace ss {
         return node;
     }
 
+    void BytesNode::hashContent(ContentHasher &hasher) const {
+        hasher.add(uint64_t(_data->size()));
+        hasher.write(_data->data(), _data->size());
+    }
+
     BytesAction::~BytesAction() = default;
 
     void BytesAction::queryNodes(bool inserted,
@@ -75,10 +84,10 @@ namespace ss {
         auto parent = static_cast<BytesNode *>(_parent.get());
         parent->beginAction();
 
-        auto &data = parent->_data;
+        auto &data = parent->_data.detach();
         // Pre-Propagate signal
         {
-            ActionNotification n(Notification::ActionAboutToTrigger, this);
+            ActionNotification n(Notification::ActionAboutToTrigger, this, undo);
             parent->notify(&n);
         }
 
@@ -92,7 +101,7 @@ namespace ss {
 
         // Post-propagate signal
         {
-            ActionNotification n(Notification::ActionTriggered, this);
+            ActionNotification n(Notification::ActionTriggered, this, undo);
             parent->notify(&n);
         }
         parent->endAction();
@@ -108,10 +117,10 @@ namespace ss {
         auto parent = static_cast<BytesNode *>(_parent.get());
         parent->beginAction();
 
-        auto &data = parent->_data;
+        auto &data = parent->_data.detach();
         // Pre-Propagate signal
         {
-            ActionNotification n(Notification::ActionAboutToTrigger, this);
+            ActionNotification n(Notification::ActionAboutToTrigger, this, undo);
             parent->notify(&n);
         }
 
@@ -121,7 +130,7 @@ namespace ss {
 
         // Post-propagate signal
         {
-            ActionNotification n(Notification::ActionTriggered, this);
+            ActionNotification n(Notification::ActionTriggered, this, undo);
             parent->notify(&n);
         }
         parent->endAction();
@@ -0,0 +1,117 @@
+#include "ContentHash.h"
+
+#include <algorithm>
+
+#include "Value.h"
+
+namespace ss {
+
+    static constexpr const uint64_t K0 = 0xa0761d6478bd642f;
+    static constexpr const uint64_t K1 = 0xe7037ed1a0b428db;
+    static constexpr const uint64_t K2 = 0x8ebc6af09c88c6e3;
+
+    // Folded 128-bit product of two words
+    static inline uint64_t mum(uint64_t a, uint64_t b) {
+#if defined(__SIZEOF_INT128__)
+        auto r = static_cast<unsigned __int128>(a) * b;
+        return uint64_t(r) ^ uint64_t(r >> 64);
+#else
+        uint64_t ha = a >> 32, la = uint32_t(a), hb = b >> 32, lb = uint32_t(b);
+        uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+        uint64_t t = rl + (rm0 << 32);
+        uint64_t lo = t + (rm1 << 32);
+        uint64_t hi = rh + (rm0 >> 32) + (rm1 >> 32) + (t < rl) + (lo < t);
+        return lo ^ hi;
+#endif
+    }
+
+    void ContentHasher::write(const void *data, size_t size) {
+        auto p = static_cast<const unsigned char *>(data);
+        size_t used = size_t(_length & 7);
+        _length += size;
+
+        // Complete the pending word
+        if (used) {
+            size_t n = std::min(size, 8 - used);
+            for (size_t i = 0; i < n; ++i) {
+                _tail |= uint64_t(p[i]) << ((used + i) * 8);
+            }
+            p += n;
+            size -= n;
+            if (used + n < 8) {
+                return;
+            }
+            consume(_tail);
+            _tail = 0;
+        }
+
+        for (; size >= 8; p += 8, size -= 8) {
+            uint64_t word = 0;
+            for (size_t i = 0; i < 8; ++i) {
+                word |= uint64_t(p[i]) << (i * 8);
+            }
+            consume(word);
+        }
+        for (size_t i = 0; i < size; ++i) {
+            _tail |= uint64_t(p[i]) << (i * 8);
+        }
+    }
+
+    void ContentHasher::add(const Value &value) {
+        add(int(value.type()));
+        switch (value.type()) {
+            case Value::Bool:
+                add(value.toBool());
+                break;
+            case Value::Int:
+                add(value.toInt());
+                break;
+            case Value::Double:
+                add(value.toDouble());
+                break;
+            case Value::String:
+                add(value.toString());
+                break;
+            default:
+                break;
+        }
+    }
+
+    Hash128 ContentHasher::finish() const {
+        uint64_t a = _a, b = _b;
+        if (_length & 7) {
+            a = mum(a ^ _tail ^ K0, K1);
+            b = mum(b ^ _tail ^ K1, K2);
+        }
+        a = mum(a ^ _length, K2 ^ b);
+        b = mum(b ^ K0, a ^ _length);
+        return {a, b};
+    }
+
+    void ContentHasher::consume(uint64_t word) {
+        _a = mum(_a ^ word ^ K0, K1);
+        _b = mum(_b ^ word ^ K1, K2) + _a;
+    }
+
+    ContentHash::ContentHash(Model *model) : Aggregate<Hash128>(model) {
+    }
+
+    ContentHash::~ContentHash() = default;
+
+    Hash128 ContentHash::local(const Node *node) const {
+        ContentHasher hasher;
+        hasher.add(node->type());
+        node->hashContent(hasher);
+        return hasher.finish();
+    }
+
+    Hash128 ContentHash::combine(const Hash128 &a, const Hash128 &b) const {
+        ContentHasher hasher;
+        hasher.add(a.low);
+        hasher.add(a.high);
+        hasher.add(b.low);
+        hasher.add(b.high);
+        return hasher.finish();
+    }
+
+}
\ No newline at end of file
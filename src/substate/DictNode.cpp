@@ -0,0 +1,136 @@
+#include "DictNode.h"
+#include "DictNode_p.h"
+
+#include <cassert>
+
+#include "Model_p.h"
+#include "Node_p.h"
+#include "ContentHash.h"
+
+namespace ss {
+
+    void DictNodePrivate::copy(DictNode *dest, const DictNode *src, bool copyId) {
+        if (copyId) {
+            dest->_id = src->_id;
+        }
+        // Clone children, the source is already sorted
+        dest->_entries.reserve(src->_entries.size());
+        for (const auto &entry : src->_entries) {
+            const auto &key = entry.first;
+            const auto &value = entry.second;
+
+            if (!value.isNode()) {
+                dest->_entries.emplace_back(key, value);
+                continue;
+            }
+
+            auto newChild = NodePrivate::clone(value.nodeRef().get(), copyId);
+            dest->addChild(newChild.get());
+            dest->_entries.emplace_back(key, newChild);
+        }
+    }
+
+    DictNode::~DictNode() {
+        deferChildren();
+    }
+
+    bool DictNode::setValue(const ValueKey &key, const Value &value) {
+        assert(isWritable());
+        assert(key.isValid());
+
+        Value oldValue;
+        auto it = lowerBound(key);
+        if (it == _entries.end() || it->first != key) {
+            // Nothing changes
+            if (!value.isValid())
+                return false;
+        } else {
+            // Nothing changes
+            if (value.isSame(it->second))
+                return false;
+            oldValue = it->second;
+        }
+        assert(!value.isNode() || value.nodeRef()->isFree());
+
+        auto a = Action::create<DictAction>(
+            actionArena(), std::static_pointer_cast<DictNode>(shared_from_this()), key,
+            std::move(oldValue), value);
+        a->execute(false);
+        ModelPrivate::pushAction(_model, std::move(a));
+        return true;
+    }
+
+    std::shared_ptr<Node> DictNode::clone(bool copyId) const {
+        auto node = std::make_shared<DictNode>(_type);
+        DictNodePrivate::copy(node.get(), this, copyId);
+        return node;
+    }
+
+    void DictNode::collectChildren(std::vector<Node *> &children) const {
+        for (const auto &entry : std::as_const(_entries)) {
+            const auto &value = entry.second;
+            if (value.isNode()) {
+                children.push_back(value.nodeRef().get());
+            }
+        }
+    }
+
+    void DictNode::hashContent(ContentHasher &hasher) const {
+        hasher.add(uint64_t(_entries.size()));
+        for (const auto &entry : std::as_const(_entries)) {
+            hasher.add(entry.first.name());
+            hasher.add(entry.second);
+        }
+    }
+
+    void DictNode::assign(const ValueKey &key, const Value &value) {
+        auto it = _entries.begin() + (lowerBound(key) - _entries.cbegin());
+        if (it == _entries.end() || it->first != key) {
+            _entries.insert(it, std::make_pair(key, value));
+        } else {
+            if (value.isValid()) {
+                it->second = value;
+            } else {
+                _entries.erase(it);
+            }
+        }
+    }
+
+    DictAction::~DictAction() = default;
+
+    void DictAction::execute(bool undo) {
+        auto parent = static_cast<DictNode *>(_parent.get());
+
+        auto &key = _key;
+        auto &value = undo ? _oldValue : _value;
+        auto &oldValue = undo ? _value : _oldValue;
+        assert(parent->value(key).isSame(oldValue));
+
+        parent->beginAction();
+
+        // Pre-Propagate signal
+        {
+            ActionNotification n(Notification::ActionAboutToTrigger, this, undo);
+            parent->notify(&n);
+        }
+
+        // Do change
+        parent->assign(key, value);
+
+        if (oldValue.isNode()) {
+            parent->removeChild(oldValue.nodeRef().get());
+        }
+        if (value.nodeRef()) {
+            parent->addChild(value.nodeRef().get());
+        }
+
+        // Propagate signal
+        {
+            ActionNotification n(Notification::ActionTriggered, this, undo);
+            parent->notify(&n);
+        }
+
+        parent->endAction();
+    }
+
+}
\ No newline at end of file
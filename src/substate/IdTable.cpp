@@ -0,0 +1,32 @@
+#include "IdTable.h"
+
+namespace ss {
+
+    IdTable::~IdTable() = default;
+
+    void IdTable::clear() {
+        _pages.clear();
+        _size = 0;
+    }
+
+    IdTable::Page &IdTable::page(size_t index) {
+        if (index >= _pages.size()) {
+            _pages.resize(index + 1);
+        }
+        auto &page = _pages[index];
+        if (!page.slots) {
+            page.slots.reset(new Node *[PageSize]());
+        }
+        return page;
+    }
+
+    void IdTable::releasePage(size_t index) {
+        _pages[index].slots.reset();
+
+        // Trim released pages at the end
+        while (!_pages.empty() && !_pages.back().slots) {
+            _pages.pop_back();
+        }
+    }
+
+}
\ No newline at end of file
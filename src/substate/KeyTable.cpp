@@ -0,0 +1 @@
+#include "KeyTable.h"
\ No newline at end of file
@@ -0,0 +1,75 @@
+#include "MemoryPool.h"
+
+#include <cassert>
+#include <algorithm>
+
+namespace ss {
+
+    MemoryPool::~MemoryPool() {
+        for (const auto &chunk : _chunks) {
+            ::operator delete(chunk);
+        }
+    }
+
+    void *MemoryPool::allocateBlock(size_t index) {
+        size_t size = (index + 1) * Alignment;
+        if (size_t(_end - _cursor) < size) {
+            // The tail of the last chunk is dropped, it's smaller than the largest class
+            auto chunk = static_cast<char *>(::operator new(ChunkSize));
+            _chunks.push_back(chunk);
+            _cursor = chunk;
+            _end = chunk + ChunkSize;
+        }
+        auto ptr = _cursor;
+        _cursor += size;
+        return ptr;
+    }
+
+    ActionArena::~ActionArena() {
+        assert(_count == 0);
+        for (auto block = _blocks; block;) {
+            auto next = block->next;
+            ::operator delete(block);
+            block = next;
+        }
+    }
+
+    void *ActionArena::allocate(size_t size) {
+        size = (size + MemoryPool::Alignment - 1) & ~(MemoryPool::Alignment - 1);
+        if (size_t(_end - _cursor) < size) {
+            // Grow geometrically, so that small transactions only take a small block
+            size_t blockSize = _blocks ? std::min(_blocks->size * 2, MaxBlockSize) : MinBlockSize;
+            blockSize = std::max(blockSize, size + MemoryPool::Alignment);
+
+            auto block = static_cast<Block *>(::operator new(blockSize));
+            block->next = _blocks;
+            block->size = blockSize;
+            _blocks = block;
+            _cursor = reinterpret_cast<char *>(block) + MemoryPool::Alignment;
+            _end = reinterpret_cast<char *>(block) + blockSize;
+        }
+        auto ptr = _cursor;
+        _cursor += size;
+        _count++;
+        return ptr;
+    }
+
+    void ActionArena::rewind() {
+        assert(_count == 0);
+        if (!_blocks) {
+            return;
+        }
+
+        // Keep the first block, which is the last one in the list
+        auto block = _blocks;
+        while (block->next) {
+            auto next = block->next;
+            ::operator delete(block);
+            block = next;
+        }
+        _blocks = block;
+        _cursor = reinterpret_cast<char *>(block) + MemoryPool::Alignment;
+        _end = reinterpret_cast<char *>(block) + block->size;
+    }
+
+}
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include <utility>
 
 #include "StorageEngine.h"
+#include "Aggregate.h"
 #include "Node_p.h"
 #include "Model_p.h"
 
@@ -13,11 +14,11 @@ namespace ss {
         auto &root = model->_root;
         model->_lockedNode = root ? root.get() : node.get();
 
-        RootChangeAction a(node, root);
+        auto a = Action::create<RootChangeAction>(model->_arena, root, node);
 
         // Pre-Propagate
         {
-            ActionNotification n(Notification::ActionAboutToTrigger, &a);
+            ActionNotification n(Notification::ActionAboutToTrigger, a.get());
             model->notify(&n);
         }
 
@@ -29,23 +30,37 @@ namespace ss {
             node->_state = Node::Active;
         }
         root = node;
+        NodePrivate::invalidateStructure(model);
 
         // Propagate signal
         {
-            ActionNotification n(Notification::ActionTriggered, &a);
+            ActionNotification n(Notification::ActionTriggered, a.get());
             model->notify(&n);
         }
 
         model->_lockedNode = nullptr;
+        pushAction(model, std::move(a));
     }
 
     Model::Model(std::unique_ptr<StorageEngine> storageEngine)
-        : _storageEngine(std::move(storageEngine)) {
+        : _storageEngine(std::move(storageEngine)), _pool(new MemoryPool()) {
+        _pool->ref();
         _storageEngine->setup(this);
     }
 
     Model::~Model() {
-        // do what?
+        for (const auto &aggregate : std::as_const(_aggregates)) {
+            aggregate->_model = nullptr;
+        }
+
+        // Tear down the document, so that no node refers to the model afterwards
+        _txActions.clear();
+        _storageEngine->reset();
+
+        if (_arena) {
+            _arena->detach();
+        }
+        _pool->deref();
     }
 
     bool Model::isWritable() const {
@@ -56,6 +71,10 @@ namespace ss {
         return _storageEngine->indexOf(id);
     }
 
+    Node *Model::find(size_t id) const {
+        return _storageEngine->find(id);
+    }
+
     void Model::setRoot(const std::shared_ptr<Node> &node) {
         assert(isWritable());
         assert(!node || node->isFree());
@@ -74,6 +93,11 @@ namespace ss {
         assert(_state == Idle);
 
         _state = Transaction;
+        if (_arena) {
+            _arena->rewind();
+        } else {
+            _arena = new ActionArena();
+        }
         _storageEngine->prepare();
     }
 
@@ -106,10 +130,12 @@ namespace ss {
             });
         }
         for (const auto &node : std::as_const(nodes)) {
-            node->propagate([this](Node *node) { NodePrivate::propagate(node, this); });
+            NodePrivate::propagate(node.get(), this);
         }
 
-        // Commit transaction to storage engine
+        // Commit transaction to storage engine, the actions keep their arena alive
+        _arena->detach();
+        _arena = nullptr;
         {
             std::vector<std::unique_ptr<Action>> actions;
             actions.swap(_txActions);
@@ -1,27 +1,212 @@
 #include "Node.h"
 
 #include <cassert>
+#include <utility>
+#include <algorithm>
+#include <unordered_map>
 
 #include "Node_p.h"
+#include "TaskPool_p.h"
 #include "Model.h"
 #include "StorageEngine.h"
+#include "Aggregate.h"
 
 namespace ss {
 
+    // Nodes whose container is being destroyed, released by the outermost ~Node
+    struct TeardownList {
+        std::vector<std::shared_ptr<Node>> nodes;
+        std::vector<Node *> children;
+        bool releasing = false;
+    };
+
+    static thread_local TeardownList teardownList;
+
+    // Clones made ahead of their containers once the recursion is too deep
+    struct CloneState {
+        int depth = 0;
+        bool bottomUp = false;
+        std::unordered_map<const Node *, std::shared_ptr<Node>> clones;
+
+        // Restore the state when a clone returns or throws
+        struct DepthGuard {
+            CloneState &state;
+            ~DepthGuard() {
+                state.depth--;
+            }
+        };
+        struct BottomUpGuard {
+            CloneState &state;
+            ~BottomUpGuard() {
+                state.bottomUp = false;
+                state.clones.clear();
+            }
+        };
+    };
+
+    static thread_local CloneState cloneState;
+
+    std::shared_ptr<Node> NodePrivate::clone(Node *node, bool copyId) {
+        static constexpr const int MaxDepth = 256;
+
+        auto &state = cloneState;
+        if (state.bottomUp) {
+            auto it = state.clones.find(node);
+            assert(it != state.clones.end());
+            auto newNode = std::move(it->second);
+            state.clones.erase(it);
+            return newNode;
+        }
+
+        if (state.depth < MaxDepth) {
+            state.depth++;
+            CloneState::DepthGuard guard{state};
+            return node->clone(copyId);
+        }
+
+        // List the subtree level by level, then clone it backwards so that the children of every
+        // container are cloned before it
+        std::vector<Node *> nodes{node};
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            nodes[i]->collectChildren(nodes);
+        }
+        state.bottomUp = true;
+        CloneState::BottomUpGuard guard{state};
+        for (auto it = nodes.rbegin(); it != nodes.rend(); ++it) {
+            state.clones.emplace(*it, (*it)->clone(copyId));
+        }
+        return std::move(state.clones.at(node));
+    }
+
     void NodePrivate::propagate(Node *node, Model *model) {
         auto engine = model->storageEngine();
-        node->propagate([model, engine](Node *node) {
+        node->traverse([model, engine](Node *node) {
             node->_model = model;
+            node->_chainState.store(0, std::memory_order_relaxed);
             node->_id = engine->addId(node, node->_id);
         });
     }
 
+    void NodePrivate::forRanges(size_t size,
+                                const std::function<void(size_t, size_t)> &func) {
+        static constexpr const size_t Grain = 64;
+
+        // The clones made ahead are only visible to this thread
+        auto pool = TaskPool::current();
+        if (!pool || size <= Grain || cloneState.bottomUp) {
+            func(0, size);
+            return;
+        }
+
+        // Nested containers spawn their own tasks, which idle workers steal
+        TaskGroup group(pool);
+        for (size_t i = 0; i < size; i += Grain) {
+            size_t end = std::min(i + Grain, size);
+            group.spawn([&func, i, end]() {
+                func(i, end); //
+            });
+        }
+        group.wait();
+    }
+
+    void NodePrivate::release(std::vector<Node *> &nodes) {
+        std::sort(nodes.begin(), nodes.end());
+        for (const auto &node : std::as_const(nodes)) {
+            // The parent is gone unless it survives as well
+            if (node->_parent && !std::binary_search(nodes.begin(), nodes.end(), node->_parent)) {
+                node->_parent = nullptr;
+            }
+            if (!node->_parent) {
+                node->_state = Node::Created;
+            }
+            node->_model = nullptr;
+            node->_id = 0;
+        }
+    }
+
+    bool NodePrivate::isChainDetached(const Node *node) {
+        assert(node->_model);
+        size_t epoch = node->_model->_structureEpoch;
+
+        // Find the nearest node with a valid cache, or the top of the chain
+        auto top = node;
+        bool detached;
+        while (true) {
+            size_t state = top->_chainState.load(std::memory_order_relaxed);
+            if ((state >> 1) == epoch) {
+                detached = state & 1;
+                break;
+            }
+            if (!top->_parent) {
+                detached = top->_state == Node::Detached;
+                break;
+            }
+            top = top->_parent;
+        }
+
+        // Cache the result on the way, so that the siblings stop at the shared ancestors, the
+        // concurrent readers all store the same value
+        size_t state = (epoch << 1) | size_t(detached);
+        for (auto p = node;; p = p->_parent) {
+            p->_chainState.store(state, std::memory_order_relaxed);
+            if (p == top)
+                break;
+        }
+        return detached;
+    }
+
+    void NodePrivate::setChainDetached(Node *node, bool detached) {
+        static constexpr const size_t Limit = 64;
+        static thread_local std::vector<Node *> stack;
+
+        // Only the subtree's own chains change, give up on large ones
+        auto model = node->_model;
+        size_t state = (model->_structureEpoch << 1) | size_t(detached);
+        size_t visited = 0;
+        stack.assign(1, node);
+        while (!stack.empty()) {
+            if (++visited > Limit) {
+                stack.clear();
+                invalidateStructure(model);
+                return;
+            }
+            auto p = stack.back();
+            stack.pop_back();
+            p->_chainState.store(state, std::memory_order_relaxed);
+            p->collectChildren(stack);
+        }
+    }
+
+    void NodePrivate::invalidateStructure(Model *model) {
+        model->_structureEpoch++;
+    }
+
     Node::~Node() {
+        for (auto rec = _aggregates; rec;) {
+            auto next = rec->next;
+            delete rec;
+            rec = next;
+        }
+
         if (_id > 0) {
             assert(_model);
-            if (!_model->_clearing)
+            if (_model->_clearing)
+                _model->_storageEngine->_ids.drop(_id);
+            else
                 _model->_storageEngine->removeId(_id);
         }
+
+        // Release the deferred descendants, the nested destructors only add to the list
+        auto &list = teardownList;
+        if (list.releasing || list.nodes.empty())
+            return;
+        list.releasing = true;
+        while (!list.nodes.empty()) {
+            auto node = std::move(list.nodes.back());
+            list.nodes.pop_back();
+            node.reset();
+        }
+        list.releasing = false;
     }
 
     bool Node::isDetached() const {
@@ -32,11 +217,12 @@ namespace ss {
         if (_state == Detached)
             return true;
 
-        // The parent is obsolete?
-        if (auto parent = _parent)
-            return parent->isDetached();
+        // The node or one of its ancestors is not managed by a model yet?
+        if (!_model)
+            return _parent && _parent->isDetached();
 
-        return false;
+        // The top of the chain is removed?
+        return NodePrivate::isChainDetached(this);
     }
 
     bool Node::isWritable() const {
@@ -44,22 +230,42 @@ namespace ss {
         if (!_model)
             return true;
 
-        // The parent is writable?
-        if (auto parent = _parent)
-            return parent->isWritable();
+        return _model->isWritable() && !NodePrivate::isChainDetached(this);
+    }
 
-        return _model->isWritable() && _state != Detached;
+    std::shared_ptr<Node> Node::parallelClone(int threads) const {
+        if (threads <= 0) {
+            threads = int(std::thread::hardware_concurrency());
+        }
+        if (threads <= 1) {
+            return clone(false);
+        }
+
+        // The pool is current on this thread until it's destroyed
+        TaskPool pool(threads);
+        return clone(false);
     }
 
     void Node::addChild(Node *node) {
+        // A removed subtree is put back
+        bool restored = node->_state == Detached && node->_model;
         node->_parent = this;
         node->_state = Active;
+        if (restored) {
+            if (_model == node->_model)
+                NodePrivate::setChainDetached(node, NodePrivate::isChainDetached(this));
+            else
+                NodePrivate::invalidateStructure(node->_model);
+        }
     }
 
     void Node::removeChild(Node *node) {
         node->_parent = nullptr;
-        if (_model)
+        if (_model) {
             node->_state = Detached;
+            if (node->_model)
+                NodePrivate::setChainDetached(node, true);
+        }
     }
 
     void Node::beginAction() {
@@ -72,15 +278,45 @@ namespace ss {
             _model->_lockedNode = nullptr;
     }
 
-    void Node::propagateChildren(const std::function<void(Node *)> &func) {
-        (void) func;
+    ActionArena *Node::actionArena() const {
+        return _model ? _model->_arena : nullptr;
+    }
+
+    void Node::collectChildren(std::vector<Node *> &children) const {
+        (void) children;
+    }
+
+    void Node::deferChildren() {
+        // Keep the children alive past the members of the container
+        auto &list = teardownList;
+        collectChildren(list.children);
+        for (const auto &child : std::as_const(list.children)) {
+            // Slots are null in a container whose clone threw halfway
+            if (child) {
+                list.nodes.push_back(child->shared_from_this());
+            }
+        }
+        list.children.clear();
+    }
+
+    void Node::hashContent(ContentHasher &hasher) const {
+        (void) hasher;
     }
 
     void Node::notify(Notification *n) {
         switch (n->type()) {
-            case Notification::ActionAboutToTrigger:
+            case Notification::ActionAboutToTrigger: {
+                if (_model) {
+                    _model->notify(n);
+                }
+                break;
+            }
             case Notification::ActionTriggered: {
                 if (_model) {
+                    // The content of this node changed
+                    for (const auto &aggregate : std::as_const(_model->_aggregates)) {
+                        aggregate->invalidate(this);
+                    }
                     _model->notify(n);
                 }
                 break;
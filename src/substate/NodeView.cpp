@@ -0,0 +1 @@
+#include "NodeView.h"
\ No newline at end of file
@@ -0,0 +1,110 @@
+#include "RecordNode.h"
+#include "RecordNode_p.h"
+
+#include <cassert>
+
+#include "Model_p.h"
+#include "Node_p.h"
+#include "ContentHash.h"
+
+namespace ss {
+
+    void RecordNodeBasePrivate::copy(RecordNodeBase *dest, const RecordNodeBase *src,
+                                     bool copyId) {
+        if (copyId) {
+            dest->_id = src->_id;
+        }
+        // Clone children
+        auto size = src->_size;
+        for (size_t i = 0; i < size; ++i) {
+            const auto &value = src->_storage[i];
+
+            if (!value.isNode()) {
+                dest->_storage[i] = value;
+                continue;
+            }
+
+            auto newChild = NodePrivate::clone(value.nodeRef().get(), copyId);
+            dest->addChild(newChild.get());
+            dest->_storage[i] = newChild;
+        }
+    }
+
+    RecordNodeBase::~RecordNodeBase() = default;
+
+    void RecordNodeBase::setAt(int index, Value value) {
+        assert(isWritable());
+        assert(index >= 0 && size_t(index) < _size);
+
+        // Nothing changes
+        if (value.isSame(_storage[index])) {
+            return;
+        }
+        assert(!value.isNode() || value.nodeRef()->isFree());
+
+        auto a = Action::create<RecordAction>(
+            actionArena(), std::static_pointer_cast<RecordNodeBase>(shared_from_this()), index,
+            _storage[index], std::move(value));
+        a->execute(false);
+        ModelPrivate::pushAction(_model, std::move(a));
+    }
+
+    void RecordNodeBase::collectChildren(std::vector<Node *> &children) const {
+        for (size_t i = 0; i < _size; ++i) {
+            const auto &value = _storage[i];
+            if (value.isNode()) {
+                children.push_back(value.nodeRef().get());
+            }
+        }
+    }
+
+    void RecordNodeBase::hashContent(ContentHasher &hasher) const {
+        hasher.add(uint64_t(_size));
+        for (size_t i = 0; i < _size; ++i) {
+            hasher.add(_storage[i]);
+        }
+    }
+
+    void RecordNodeBase::copy(RecordNodeBase *dest, const RecordNodeBase *src, bool copyId) {
+        RecordNodeBasePrivate::copy(dest, src, copyId);
+    }
+
+    RecordAction::~RecordAction() = default;
+
+    void RecordAction::execute(bool undo) {
+        auto parent = static_cast<RecordNodeBase *>(_parent.get());
+
+        auto &index = _index;
+        auto &value = undo ? _oldValue : _value;
+        auto &oldValue = undo ? _value : _oldValue;
+        auto &storage = parent->_storage;
+        assert(storage[index].isSame(oldValue));
+
+        parent->beginAction();
+
+        // Pre-Propagate signal
+        {
+            ActionNotification n(Notification::ActionAboutToTrigger, this, undo);
+            parent->notify(&n);
+        }
+
+        // Do change
+        storage[index] = value;
+
+        if (oldValue.isNode()) {
+            parent->removeChild(oldValue.nodeRef().get());
+        }
+        if (value.isNode()) {
+            parent->addChild(value.nodeRef().get());
+        }
+
+        // Propagate signal
+        {
+            ActionNotification n(Notification::ActionTriggered, this, undo);
+            parent->notify(&n);
+        }
+
+        parent->endAction();
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1 @@
+#include "SharedData.h"
\ No newline at end of file
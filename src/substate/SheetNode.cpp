@@ -3,71 +3,118 @@
 
 #include <cassert>
 #include <utility>
+#include <algorithm>
+
+#ifdef _MSC_VER
+#  include <intrin.h>
+#endif
 
 #include "Model_p.h"
 #include "Node_p.h"
+#include "ContentHash.h"
 
 namespace ss {
 
+    static inline int countTrailingZeros(uint64_t bits) {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward64(&index, bits);
+        return int(index);
+#else
+        return __builtin_ctzll(bits);
+#endif
+    }
+
     void SheetNodePrivate::copy(SheetNode *dest, const SheetNode *src, bool copyId) {
-        if (!copyId) {
+        using Page = SheetNode::Page;
+
+        if (copyId) {
             dest->_id = src->_id;
         }
-        // Clone children
-        dest->_sheet.reserve(src->_sheet.size());
-        for (auto it = src->_sheet.begin(); it != src->_sheet.end(); ++it) {
-            auto newChild = NodePrivate::clone(it->second.get(), copyId);
-            dest->addChild(newChild.get());
-            dest->_sheet.insert(std::make_pair(it->first, newChild));
+
+        // Allocate the pages first, then clone the children by ranges of slots
+        dest->_pages.resize(src->_pages.size());
+        for (size_t i = 0; i < src->_pages.size(); ++i) {
+            if (const Page *page = src->_pages[i].get()) {
+                auto newPage = std::make_unique<Page>();
+                std::copy(std::begin(page->live), std::end(page->live), newPage->live);
+                newPage->count = page->count;
+                dest->_pages[i] = std::move(newPage);
+            }
         }
+        size_t slots = src->_pages.size() * SheetNode::PageSize;
+        NodePrivate::forRanges(slots, [dest, src, copyId](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                const Page *page = src->_pages[i >> SheetNode::PageBits].get();
+                if (!page) {
+                    continue;
+                }
+                size_t slot = i & (SheetNode::PageSize - 1);
+                if (const auto &child = page->slots[slot]) {
+                    auto newChild = NodePrivate::clone(child.get(), copyId);
+                    dest->addChild(newChild.get());
+                    dest->_pages[i >> SheetNode::PageBits]->slots[slot] = std::move(newChild);
+                }
+            }
+        });
+        dest->_firstPage = src->_firstPage;
+        dest->_size = src->_size;
         dest->_maxId = src->_maxId;
     }
 
-    SheetNode::~SheetNode() = default;
+    SheetNode::~SheetNode() {
+        deferChildren();
+    }
 
     int SheetNode::insert(const std::shared_ptr<Node> &node) {
         assert(isWritable());
         assert(node && node->isFree());
 
         int id = _maxId = _maxId + 1;
-        auto a = std::make_unique<SheetAction>(
-            Action::SheetInsert, std::static_pointer_cast<SheetNode>(shared_from_this()), id, node);
+        auto a = Action::create<SheetAction>(
+            actionArena(), Action::SheetInsert,
+            std::static_pointer_cast<SheetNode>(shared_from_this()), id, node);
         a->execute(false);
         ModelPrivate::pushAction(_model, std::move(a));
         return id;
     }
 
-    bool SheetNode::remove(int id) {
+    int SheetNode::insertMany(std::vector<std::shared_ptr<Node>> nodes) {
         assert(isWritable());
 
-        auto it = _sheet.find(_id);
-        if (it == _sheet.end()) {
-            return false;
+        // Nothing to insert, no id is allocated
+        if (nodes.empty()) {
+            return -1;
         }
-        const auto &node = it->second;
-
-        beginAction();
-
-        auto a = std::make_unique<SheetAction>(
-            Action::SheetRemove, std::static_pointer_cast<SheetNode>(shared_from_this()), id, node);
 
-        // Pre-Propagate
-        {
-            ActionNotification n(Notification::ActionAboutToTrigger, a.get());
-            notify(&n);
+#ifndef NDEBUG
+        for (const auto &node : nodes) {
+            assert(node && node->isFree());
         }
+#endif
 
-        // Do change
-        removeChild(node.get());
-        _sheet.erase(it);
+        int id = _maxId + 1;
+        _maxId += int(nodes.size());
+        auto a = Action::create<SheetBulkAction>(
+            actionArena(), Action::SheetInsertMany,
+            std::static_pointer_cast<SheetNode>(shared_from_this()), id, std::move(nodes));
+        a->execute(false);
+        ModelPrivate::pushAction(_model, std::move(a));
+        return id;
+    }
 
-        // Propagate signal
-        {
-            ActionNotification n(Notification::ActionTriggered, a.get());
-            notify(&n);
+    bool SheetNode::remove(int id) {
+        assert(isWritable());
+
+        auto node = at(id);
+        if (!node) {
+            return false;
         }
 
-        endAction();
+        auto a = Action::create<SheetAction>(
+            actionArena(), Action::SheetRemove,
+            std::static_pointer_cast<SheetNode>(shared_from_this()), id, node);
+        a->execute(false);
         ModelPrivate::pushAction(_model, std::move(a));
         return true;
     }
@@ -78,9 +125,119 @@ namespace ss {
         return node;
     }
 
-    void SheetNode::propagateChildren(const std::function<void(Node *)> &func) {
-        for (const auto &pair : std::as_const(_sheet)) {
-            NodePrivate::propagate(pair.second.get(), func);
+    void SheetNode::collectChildren(std::vector<Node *> &children) const {
+        for (const auto &pair : data()) {
+            children.push_back(pair.second.get());
+        }
+    }
+
+    void SheetNode::hashContent(ContentHasher &hasher) const {
+        hasher.add(uint64_t(_size));
+        for (const auto &item : data()) {
+            hasher.add(item.first);
+        }
+    }
+
+    size_t SheetNode::nextLive(size_t id) const {
+        size_t end = endId();
+        id = std::max(id, _firstPage << PageBits);
+        if (id >= end) {
+            return end;
+        }
+
+        size_t index = (id >> PageBits) - _firstPage;
+        size_t slot = id & (PageSize - 1);
+        for (; index < _pages.size(); ++index, slot = 0) {
+            const Page *page = _pages[index].get();
+            if (!page) {
+                continue;
+            }
+            for (size_t word = slot >> 6; word < PageSize / 64; ++word) {
+                uint64_t bits = page->live[word];
+                if (word == slot >> 6) {
+                    bits &= ~uint64_t(0) << (slot & 63);
+                }
+                if (bits) {
+                    return ((_firstPage + index) << PageBits) + (word << 6) +
+                           countTrailingZeros(bits);
+                }
+            }
+        }
+        return end;
+    }
+
+    SheetNode::Page &SheetNode::page(size_t id) {
+        size_t index = id >> PageBits;
+        if (_pages.empty()) {
+            _firstPage = index;
+        } else if (index < _firstPage) {
+            // Restoring released ids, grow in front
+            std::vector<std::unique_ptr<Page>> pages(_firstPage - index);
+            pages.insert(pages.end(), std::make_move_iterator(_pages.begin()),
+                         std::make_move_iterator(_pages.end()));
+            _pages.swap(pages);
+            _firstPage = index;
+        }
+
+        index -= _firstPage;
+        if (index >= _pages.size()) {
+            _pages.resize(index + 1);
+        }
+        auto &page = _pages[index];
+        if (!page) {
+            page = std::make_unique<Page>();
+        }
+        return *page;
+    }
+
+    void SheetNode::releasePage(size_t index) {
+        _pages[index].reset();
+
+        // Trim released pages at both ends
+        while (!_pages.empty() && !_pages.back()) {
+            _pages.pop_back();
+        }
+        auto it = std::find_if(_pages.begin(), _pages.end(),
+                               [](const std::unique_ptr<Page> &page) { return bool(page); });
+        _firstPage += size_t(it - _pages.begin());
+        _pages.erase(_pages.begin(), it);
+    }
+
+    void SheetNode::setSlot(int id, const std::shared_ptr<Node> &node) {
+        auto &page = this->page(size_t(id));
+
+        size_t slot = size_t(id) & (PageSize - 1);
+        assert(!page.slots[slot]);
+        page.slots[slot] = node;
+        page.live[slot >> 6] |= uint64_t(1) << (slot & 63);
+        page.count++;
+        _size++;
+    }
+
+    void SheetNode::setSlots(int id, ArrayView<std::shared_ptr<Node>> nodes) {
+        for (const auto &node : nodes) {
+            setSlot(id++, node);
+        }
+    }
+
+    void SheetNode::clearSlot(int id) {
+        size_t index = (size_t(id) >> PageBits) - _firstPage;
+        assert(index < _pages.size() && _pages[index]);
+
+        auto &page = *_pages[index];
+        size_t slot = size_t(id) & (PageSize - 1);
+        assert(page.slots[slot]);
+        page.slots[slot].reset();
+        page.live[slot >> 6] &= ~(uint64_t(1) << (slot & 63));
+        _size--;
+        if (--page.count == 0) {
+            releasePage(index);
+        }
+    }
+
+    void SheetNode::clearSlots(int id, int count) {
+        for (int i = 0; i < count; ++i) {
+            clearSlot(id + i);
         }
     }
 
@@ -94,31 +251,67 @@ namespace ss {
     void SheetAction::execute(bool undo) {
         auto parent = static_cast<SheetNode *>(_parent.get());
 
+        parent->beginAction();
         // Pre-Propagate
         {
-            ActionNotification n(Notification::ActionAboutToTrigger, this);
+            ActionNotification n(Notification::ActionAboutToTrigger, this, undo);
             parent->notify(&n);
         }
 
         // Do change
         if ((_type == SheetRemove) ^ undo) {
-            auto it = parent->_sheet.find(_id);
-            assert(it != parent->_sheet.end());
+            assert(parent->nodeAt(_id) == _child.get());
+            parent->removeChild(_child.get());
+            parent->clearSlot(_id);
+        } else {
+            parent->addChild(_child.get());
+            parent->setSlot(_id, _child);
+        }
 
-            const auto &node = it->second;
-            assert(node.get() == _child.get());
+        // Propagate signal
+        {
+            ActionNotification n(Notification::ActionTriggered, this, undo);
+            parent->notify(&n);
+        }
+
+        parent->endAction();
+    }
+
+    void SheetBulkAction::queryNodes(
+        bool inserted, const std::function<void(const std::shared_ptr<Node> &)> &add) {
+        if (inserted == (_type == Action::SheetInsertMany)) {
+            for (const auto &node : std::as_const(_children)) {
+                add(node);
+            }
+        }
+    }
 
-            // Do change
-            parent->removeChild(node.get());
-            parent->_sheet.erase(it);
+    void SheetBulkAction::execute(bool undo) {
+        auto parent = static_cast<SheetNode *>(_parent.get());
+
+        parent->beginAction();
+        // Pre-Propagate
+        {
+            ActionNotification n(Notification::ActionAboutToTrigger, this, undo);
+            parent->notify(&n);
+        }
+
+        // Do change
+        if (undo) {
+            for (const auto &node : std::as_const(_children)) {
+                parent->removeChild(node.get());
+            }
+            parent->clearSlots(_id, int(_children.size()));
         } else {
-            parent->addChild(_child.get());
-            parent->_sheet.insert(std::make_pair(_id, _child));
+            for (const auto &node : std::as_const(_children)) {
+                parent->addChild(node.get());
+            }
+            parent->setSlots(_id, _children);
         }
 
         // Propagate signal
         {
-            ActionNotification n(Notification::ActionTriggered, this);
+            ActionNotification n(Notification::ActionTriggered, this, undo);
             parent->notify(&n);
         }
 
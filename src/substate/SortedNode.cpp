@@ -0,0 +1,260 @@
+#include "SortedNode.h"
+#include "SortedNode_p.h"
+
+#include <cassert>
+#include <utility>
+
+#include "Model_p.h"
+#include "Node_p.h"
+#include "ContentHash.h"
+
+namespace ss {
+
+    static inline int countOf(const SortedView::Tree::Node *node) {
+        return node ? node->summary.count : 0;
+    }
+
+    void SortedNodePrivate::copy(SortedNode *dest, const SortedNode *src, bool copyId) {
+        if (copyId) {
+            dest->_id = src->_id;
+        }
+        // Clone children, they're visited in order so they can be appended directly
+        dest->_index.resize(src->_index.size());
+        for (const auto &item : src->data()) {
+            auto newChild = NodePrivate::clone(item.node.get(), copyId);
+            dest->addChild(newChild.get());
+            dest->_index[item.id] = dest->_tree.pushBack({item.id, item.key, std::move(newChild)});
+        }
+        dest->_maxId = src->_maxId;
+    }
+
+    SortedNode::~SortedNode() {
+        deferChildren();
+    }
+
+    int SortedNode::insert(const std::shared_ptr<Node> &node, Value key) {
+        assert(isWritable());
+        assert(node && node->isFree());
+        assert(!key.isNode());
+
+        int id = _maxId = _maxId + 1;
+        auto a = Action::create<SortedAction>(
+            actionArena(), Action::SortedInsert,
+            std::static_pointer_cast<SortedNode>(shared_from_this()),
+            SortedItem{id, std::move(key), node});
+        a->execute(false);
+        ModelPrivate::pushAction(_model, std::move(a));
+        return id;
+    }
+
+    bool SortedNode::remove(int id) {
+        assert(isWritable());
+
+        auto item = this->item(id);
+        if (!item) {
+            return false;
+        }
+
+        auto a = Action::create<SortedAction>(
+            actionArena(), Action::SortedRemove,
+            std::static_pointer_cast<SortedNode>(shared_from_this()), *item);
+        a->execute(false);
+        ModelPrivate::pushAction(_model, std::move(a));
+        return true;
+    }
+
+    bool SortedNode::rekey(int id, Value key) {
+        assert(isWritable());
+        assert(!key.isNode());
+
+        auto item = this->item(id);
+        if (!item) {
+            return false;
+        }
+
+        // Nothing changes
+        if (item->key == key) {
+            return false;
+        }
+
+        auto a = Action::create<SortedRekeyAction>(
+            actionArena(), std::static_pointer_cast<SortedNode>(shared_from_this()), id, item->key,
+            std::move(key));
+        a->execute(false);
+        ModelPrivate::pushAction(_model, std::move(a));
+        return true;
+    }
+
+    int SortedNode::rank(int id) const {
+        if (size_t(id) >= _index.size() || !_index[id]) {
+            return -1;
+        }
+
+        // Count the items before the node on the way up
+        const Tree::Node *node = _index[id];
+        int res = countOf(node->left);
+        for (auto parent = node->parent; parent; node = parent, parent = parent->parent) {
+            if (parent->right == node) {
+                res += countOf(parent->left) + 1;
+            }
+        }
+        return res;
+    }
+
+    const SortedItem &SortedNode::select(int rank) const {
+        assert(rank >= 0 && rank < size());
+
+        auto node = _tree.root();
+        while (true) {
+            int left = countOf(node->left);
+            if (rank < left) {
+                node = node->left;
+            } else if (rank == left) {
+                break;
+            } else {
+                rank -= left + 1;
+                node = node->right;
+            }
+        }
+        return node->value;
+    }
+
+    int SortedNode::lowerBound(const Value &key) const {
+        int res = size();
+        int before = 0;
+        for (auto node = _tree.root(); node;) {
+            if (!(node->value.key < key)) {
+                res = before + countOf(node->left);
+                node = node->left;
+            } else {
+                before += countOf(node->left) + 1;
+                node = node->right;
+            }
+        }
+        return res;
+    }
+
+    int SortedNode::upperBound(const Value &key) const {
+        int res = size();
+        int before = 0;
+        for (auto node = _tree.root(); node;) {
+            if (key < node->value.key) {
+                res = before + countOf(node->left);
+                node = node->left;
+            } else {
+                before += countOf(node->left) + 1;
+                node = node->right;
+            }
+        }
+        return res;
+    }
+
+    std::shared_ptr<Node> SortedNode::clone(bool copyId) const {
+        auto node = std::make_shared<SortedNode>(_type);
+        SortedNodePrivate::copy(node.get(), this, copyId);
+        return node;
+    }
+
+    void SortedNode::collectChildren(std::vector<Node *> &children) const {
+        _tree.forEach([&children](const SortedItem &item) {
+            children.push_back(item.node.get()); //
+        });
+    }
+
+    void SortedNode::hashContent(ContentHasher &hasher) const {
+        hasher.add(uint64_t(size()));
+        _tree.forEach([&hasher](const SortedItem &item) {
+            hasher.add(item.id);
+            hasher.add(item.key);
+        });
+    }
+
+    void SortedNode::insertItem(const SortedItem &item) {
+        if (size_t(item.id) >= _index.size()) {
+            _index.resize(item.id + 1);
+        }
+        assert(!_index[item.id]);
+
+        // Order by key, then by id
+        _index[item.id] = _tree.insert(
+            [&item](const SortedTraits::summary_type &, const SortedItem &other) {
+                return other.key < item.key || (!(item.key < other.key) && other.id < item.id);
+            },
+            item);
+    }
+
+    SortedItem SortedNode::removeItem(int id) {
+        auto node = _index[id];
+        assert(node);
+
+        _index[id] = nullptr;
+        return _tree.erase(node);
+    }
+
+    void SortedAction::queryNodes(bool inserted,
+                                  const std::function<void(const std::shared_ptr<Node> &)> &add) {
+        if (inserted == (_type == Action::SortedInsert)) {
+            add(_item.node);
+        }
+    }
+
+    void SortedAction::execute(bool undo) {
+        auto parent = static_cast<SortedNode *>(_parent.get());
+
+        parent->beginAction();
+        // Pre-Propagate
+        {
+            ActionNotification n(Notification::ActionAboutToTrigger, this, undo);
+            parent->notify(&n);
+        }
+
+        // Do change
+        if ((_type == SortedRemove) ^ undo) {
+            assert(parent->nodeAt(_item.id) == _item.node.get());
+            parent->removeChild(_item.node.get());
+            parent->removeItem(_item.id);
+        } else {
+            parent->addChild(_item.node.get());
+            parent->insertItem(_item);
+        }
+
+        // Propagate signal
+        {
+            ActionNotification n(Notification::ActionTriggered, this, undo);
+            parent->notify(&n);
+        }
+
+        parent->endAction();
+    }
+
+    void SortedRekeyAction::queryNodes(
+        bool inserted, const std::function<void(const std::shared_ptr<Node> &)> &add) {
+        (void) inserted;
+        (void) add;
+    }
+
+    void SortedRekeyAction::execute(bool undo) {
+        auto parent = static_cast<SortedNode *>(_parent.get());
+
+        parent->beginAction();
+        // Pre-Propagate
+        {
+            ActionNotification n(Notification::ActionAboutToTrigger, this, undo);
+            parent->notify(&n);
+        }
+
+        // Do change
+        auto item = parent->removeItem(_id);
+        item.key = undo ? _oldKey : _key;
+        parent->insertItem(item);
+
+        // Propagate signal
+        {
+            ActionNotification n(Notification::ActionTriggered, this, undo);
+            parent->notify(&n);
+        }
+
+        parent->endAction();
+    }
+
+}
\ No newline at end of file
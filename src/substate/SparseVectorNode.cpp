@@ -0,0 +1,355 @@
+#include "SparseVectorNode.h"
+#include "SparseVectorNode_p.h"
+
+#include <cassert>
+
+#include "Model_p.h"
+#include "Node_p.h"
+#include "ContentHash.h"
+
+namespace ss {
+
+    using Tree = SparseVectorView::Tree;
+
+    // Returns the first child at or behind the index and its index in pos
+    static Tree::Node *lowerBound(const Tree &tree, int index, int &pos) {
+        auto node = tree.root();
+        int before = 0;
+        while (node) {
+            int leftLength = node->left ? node->left->summary.length : 0;
+            if (index < before + leftLength) {
+                node = node->left;
+                continue;
+            }
+            before += leftLength;
+            pos = before + node->value.gap;
+            if (index <= pos) {
+                break;
+            }
+            before = pos + 1;
+            node = node->right;
+        }
+        return node;
+    }
+
+    void SparseVectorNodePrivate::copy(SparseVectorNode *dest, const SparseVectorNode *src,
+                                       bool copyId) {
+        if (copyId) {
+            dest->_id = src->_id;
+        }
+        // Clone children, they're visited in order so they can be appended directly
+        src->_tree.forEach([dest, copyId](const SparseVectorEntry &entry) {
+            auto newChild = NodePrivate::clone(entry.node.get(), copyId);
+            dest->addChild(newChild.get());
+            dest->_tree.pushBack({entry.gap, std::move(newChild)});
+        });
+        dest->_size = src->_size;
+    }
+
+    Tree SparseVectorNodePrivate::splitAt(Tree &tree, int index, int &gap) {
+        auto right = tree.split([index](const SparseVectorTraits::summary_type &prefix,
+                                        const SparseVectorEntry &entry) {
+            return prefix.length + entry.gap < index; //
+        });
+        gap = index - tree.summary().length;
+        if (auto first = right.first()) {
+            first->value.gap -= gap;
+            right.refresh(first);
+        }
+        return right;
+    }
+
+    int SparseVectorNodePrivate::join(Tree &tree, int gap, Tree right) {
+        auto first = right.first();
+        if (!first) {
+            return gap;
+        }
+        first->value.gap += gap;
+        right.refresh(first);
+        tree.append(std::move(right));
+        return 0;
+    }
+
+    SparseVectorNode::~SparseVectorNode() {
+        deferChildren();
+    }
+
+    void SparseVectorNode::insert(int index, std::vector<std::shared_ptr<Node>> nodes) {
+        assert(isWritable());
+        assert(NodePrivate::validateArrayQueryArguments(index, _size));
+        assert(!nodes.empty());
+
+        std::vector<SparseVectorItem> items;
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            if (!nodes[i]) {
+                continue;
+            }
+            assert(nodes[i]->isFree());
+            items.push_back({int(i), std::move(nodes[i])});
+        }
+
+        auto action = Action::create<SparseVectorInsDelAction>(
+            actionArena(), Action::SparseVectorInsert,
+            std::static_pointer_cast<SparseVectorNode>(shared_from_this()), index,
+            int(nodes.size()), std::move(items));
+        action->execute(false);
+        ModelPrivate::pushAction(_model, std::move(action));
+    }
+
+    void SparseVectorNode::insertEmpty(int index, int count) {
+        assert(isWritable());
+        assert(NodePrivate::validateArrayQueryArguments(index, _size) && count > 0);
+
+        auto action = Action::create<SparseVectorInsDelAction>(
+            actionArena(), Action::SparseVectorInsert,
+            std::static_pointer_cast<SparseVectorNode>(shared_from_this()), index, count,
+            std::vector<SparseVectorItem>());
+        action->execute(false);
+        ModelPrivate::pushAction(_model, std::move(action));
+    }
+
+    void SparseVectorNode::move(int index, int count, int dest) {
+        assert(isWritable());
+        assert(NodePrivate::validateArrayRemoveArguments(index, count, _size) &&
+               NodePrivate::validateArrayQueryArguments(dest, _size) &&
+               !(dest >= index && dest < index + count));
+
+        auto action = Action::create<SparseVectorMoveAction>(
+            actionArena(), std::static_pointer_cast<SparseVectorNode>(shared_from_this()), index,
+            count, dest);
+        action->execute(false);
+        ModelPrivate::pushAction(_model, std::move(action));
+    }
+
+    void SparseVectorNode::remove(int index, int count) {
+        assert(isWritable());
+        assert(NodePrivate::validateArrayRemoveArguments(index, count, _size));
+
+        // Collect the children in the range only, empty regions cost nothing
+        std::vector<SparseVectorItem> items;
+        int pos;
+        for (auto node = lowerBound(_tree, index, pos); node && pos < index + count;) {
+            items.push_back({pos - index, node->value.node});
+            if ((node = Tree::next(node)))
+                pos += node->value.gap + 1;
+        }
+
+        auto action = Action::create<SparseVectorInsDelAction>(
+            actionArena(), Action::SparseVectorRemove,
+            std::static_pointer_cast<SparseVectorNode>(shared_from_this()), index, count,
+            std::move(items));
+        action->execute(false);
+        ModelPrivate::pushAction(_model, std::move(action));
+    }
+
+    void SparseVectorNode::replace(int index, const std::shared_ptr<Node> &node) {
+        assert(isWritable());
+        assert(index >= 0 && index < _size);
+        assert(!node || node->isFree());
+
+        auto oldNode = at(index);
+        if (oldNode == node) {
+            return;
+        }
+
+        auto action = Action::create<SparseVectorReplaceAction>(
+            actionArena(), std::static_pointer_cast<SparseVectorNode>(shared_from_this()), index,
+            oldNode, node);
+        action->execute(false);
+        ModelPrivate::pushAction(_model, std::move(action));
+    }
+
+    std::shared_ptr<Node> SparseVectorNode::at(int index) const {
+        int pos;
+        auto node = lowerBound(_tree, index, pos);
+        if (!node || pos != index) {
+            return {};
+        }
+        return node->value.node;
+    }
+
+    int SparseVectorNode::nextIndex(int index) const {
+        int pos;
+        return lowerBound(_tree, index, pos) ? pos : _size;
+    }
+
+    std::shared_ptr<Node> SparseVectorNode::clone(bool copyId) const {
+        auto node = std::make_shared<SparseVectorNode>(_type);
+        SparseVectorNodePrivate::copy(node.get(), this, copyId);
+        return node;
+    }
+
+    void SparseVectorNode::collectChildren(std::vector<Node *> &children) const {
+        _tree.forEach([&children](const SparseVectorEntry &entry) {
+            children.push_back(entry.node.get()); //
+        });
+    }
+
+    void SparseVectorNode::hashContent(ContentHasher &hasher) const {
+        hasher.add(uint64_t(_size));
+        _tree.forEach([&hasher](const SparseVectorEntry &entry) {
+            hasher.add(entry.gap); //
+        });
+    }
+
+    void SparseVectorInsDelAction::queryNodes(
+        bool inserted, const std::function<void(const std::shared_ptr<Node> &)> &add) {
+        if (inserted == (_type == Action::SparseVectorInsert)) {
+            for (const auto &item : std::as_const(_items)) {
+                add(item.node);
+            }
+        }
+    }
+
+    void SparseVectorInsDelAction::execute(bool undo) {
+        auto parent = static_cast<SparseVectorNode *>(_parent.get());
+        auto &tree = parent->_tree;
+
+        parent->beginAction();
+        // Pre-Propagate signal
+        {
+            ActionNotification n(Notification::ActionAboutToTrigger, this, undo);
+            parent->notify(&n);
+        }
+
+        // Do change
+        int gap;
+        auto rest = SparseVectorNodePrivate::splitAt(tree, _index, gap);
+        if (((_type == SparseVectorRemove) ^ undo)) {
+            int tail;
+            auto after = SparseVectorNodePrivate::splitAt(rest, _count, tail);
+            rest.forEach([parent](const SparseVectorEntry &entry) {
+                parent->removeChild(entry.node.get()); //
+            });
+            rest.clear();
+            SparseVectorNodePrivate::join(tree, gap, std::move(after));
+            parent->_size -= _count;
+        } else {
+            int last = -1;
+            for (const auto &item : std::as_const(_items)) {
+                parent->addChild(item.node.get());
+                tree.pushBack({gap + item.index - last - 1, item.node});
+                gap = 0;
+                last = item.index;
+            }
+            SparseVectorNodePrivate::join(tree, gap + _count - last - 1, std::move(rest));
+            parent->_size += _count;
+        }
+
+        // Post-propagate signal
+        {
+            ActionNotification n(Notification::ActionTriggered, this, undo);
+            parent->notify(&n);
+        }
+        parent->endAction();
+    }
+
+    void SparseVectorMoveAction::queryNodes(
+        bool inserted, const std::function<void(const std::shared_ptr<Node> &)> &add) {
+        (void) inserted;
+        (void) add;
+    }
+
+    void SparseVectorMoveAction::execute(bool undo) {
+        auto parent = static_cast<SparseVectorNode *>(_parent.get());
+        auto &tree = parent->_tree;
+
+        parent->beginAction();
+        // Pre-Propagate signal
+        {
+            ActionNotification n(Notification::ActionAboutToTrigger, this, undo);
+            parent->notify(&n);
+        }
+
+        // Do change
+        int index;
+        int dest;
+        if (undo) {
+            if (_dest > _index) {
+                index = _dest - _count;
+                dest = _index;
+            } else {
+                index = _dest;
+                dest = _index + _count;
+            }
+        } else {
+            index = _index;
+            dest = _dest;
+        }
+
+        // Cut out the range, then put it back at the destination
+        int gap, tail;
+        auto range = SparseVectorNodePrivate::splitAt(tree, index, gap);
+        auto after = SparseVectorNodePrivate::splitAt(range, _count, tail);
+        SparseVectorNodePrivate::join(tree, gap, std::move(after));
+
+        auto rest =
+            SparseVectorNodePrivate::splitAt(tree, dest > index ? dest - _count : dest, gap);
+        gap = SparseVectorNodePrivate::join(tree, gap, std::move(range)) + tail;
+        SparseVectorNodePrivate::join(tree, gap, std::move(rest));
+
+        // Propagate signal
+        {
+            ActionNotification n(Notification::ActionTriggered, this, undo);
+            parent->notify(&n);
+        }
+        parent->endAction();
+    }
+
+    void SparseVectorReplaceAction::queryNodes(
+        bool inserted, const std::function<void(const std::shared_ptr<Node> &)> &add) {
+        const auto &node = inserted ? _child : _oldChild;
+        if (node) {
+            add(node);
+        }
+    }
+
+    void SparseVectorReplaceAction::execute(bool undo) {
+        auto parent = static_cast<SparseVectorNode *>(_parent.get());
+        auto &tree = parent->_tree;
+
+        parent->beginAction();
+        // Pre-Propagate signal
+        {
+            ActionNotification n(Notification::ActionAboutToTrigger, this, undo);
+            parent->notify(&n);
+        }
+
+        // Do change
+        const auto &oldChild = undo ? _child : _oldChild;
+        const auto &child = undo ? _oldChild : _child;
+
+        // Take the slot out, it's either a child or the first empty slot of the rest
+        int gap;
+        auto rest = SparseVectorNodePrivate::splitAt(tree, _index, gap);
+        if (oldChild) {
+            assert(rest.first()->value.node == oldChild);
+            parent->removeChild(oldChild.get());
+            auto entry = rest.erase(rest.first());
+            if (auto first = rest.first()) {
+                first->value.gap += entry.gap;
+                rest.refresh(first);
+            }
+        } else if (auto first = rest.first()) {
+            first->value.gap--;
+            rest.refresh(first);
+        }
+
+        if (child) {
+            parent->addChild(child.get());
+            tree.pushBack({gap, child});
+            gap = 0;
+        } else {
+            gap++;
+        }
+        SparseVectorNodePrivate::join(tree, gap, std::move(rest));
+
+        // Propagate signal
+        {
+            ActionNotification n(Notification::ActionTriggered, this, undo);
+            parent->notify(&n);
+        }
+        parent->endAction();
+    }
+
+}
\ No newline at end of file
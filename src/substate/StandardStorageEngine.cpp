@@ -64,19 +64,19 @@ namespace ss {
     }
 
     void StandardStorageEngine::reset() {
+        // Only drop the slots when deleting items, the table is cleared in whole later
         _model->_clearing = true;
 
         // Delete all nodes
         _model->_root.reset();
         _stack.clear();
 
+        _model->_clearing = false;
+
         _min = 0;
         _current = 0;
 
-        _idMap.clear();
-        _maxId = 0;
-
-        _model->_clearing = false;
+        releaseIds();
     }
 
     int StandardStorageEngine::minimum() const {
@@ -1,6 +1,7 @@
 #include "StorageEngine.h"
 
 #include "Model.h"
+#include "Node_p.h"
 
 namespace ss {
 
@@ -17,7 +18,7 @@ namespace ss {
     }
 
     void StorageEngine::reset() {
-        // Skip removing index when deleting item to speed up
+        // Only drop the slots when deleting items, the table is cleared in whole later
         _model->_clearing = true;
 
         // Remove root item
@@ -25,13 +26,27 @@ namespace ss {
 
         _model->_clearing = false;
 
-        _idMap.clear();
+        releaseIds();
+    }
+
+    void StorageEngine::releaseIds() {
+        // Only the surviving nodes are left in the table, which is usually empty by now
+        if (_ids.size() > 0) {
+            std::vector<Node *> nodes;
+            nodes.reserve(_ids.size());
+            _ids.forEach([&nodes](size_t id, Node *node) {
+                (void) id;
+                nodes.push_back(node);
+            });
+            NodePrivate::release(nodes);
+        }
+        _ids.clear();
         _maxId = 0;
     }
 
     size_t StorageEngine::addId(Node *node, size_t id) {
         size_t newId = id > 0 ? (_maxId = std::max(_maxId, id), id) : (++_maxId);
-        _idMap.insert(std::make_pair(newId, node));
+        _ids.insert(newId, node);
         return newId;
     }
 
@@ -0,0 +1,151 @@
+#include "TaskPool_p.h"
+
+#include <cassert>
+#include <algorithm>
+
+namespace ss {
+
+    // The pool the current thread works for and its queue index
+    static thread_local TaskPool *currentPool = nullptr;
+    static thread_local int currentIndex = 0;
+
+    TaskPool::TaskPool(int threads) : _previous(currentPool), _previousIndex(currentIndex) {
+        int n = std::max(threads, 1);
+        _queues.reserve(n);
+        for (int i = 0; i < n; ++i) {
+            _queues.emplace_back(std::make_unique<Queue>());
+        }
+
+        // The creating thread is worker 0
+        currentPool = this;
+        currentIndex = 0;
+
+        _threads.reserve(n - 1);
+        for (int i = 1; i < n; ++i) {
+            _threads.emplace_back([this, i]() {
+                currentPool = this;
+                currentIndex = i;
+                work();
+            });
+        }
+    }
+
+    TaskPool::~TaskPool() {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _cv.notify_all();
+        for (auto &thread : _threads) {
+            thread.join();
+        }
+
+        currentPool = _previous;
+        currentIndex = _previousIndex;
+    }
+
+    TaskPool *TaskPool::current() {
+        return currentPool;
+    }
+
+    void TaskPool::push(Task task) {
+        assert(currentPool == this);
+        {
+            auto &queue = *_queues[currentIndex];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.tasks.push_back(std::move(task));
+        }
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _pending++;
+        }
+        _cv.notify_one();
+    }
+
+    bool TaskPool::pop(Task &task) {
+        int n = int(_queues.size());
+
+        // Take the latest task of our own, which is the hottest in cache
+        {
+            auto &queue = *_queues[currentIndex];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.tasks.empty()) {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+                _pending--;
+                return true;
+            }
+        }
+
+        // Steal the oldest task of another worker, which is likely the largest
+        for (int i = 1; i < n; ++i) {
+            auto &queue = *_queues[(currentIndex + i) % n];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.tasks.empty()) {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+                _pending--;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void TaskPool::run(Task &task) {
+        auto group = task.group;
+        try {
+            task.func();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(group->_mutex);
+            if (!group->_exception) {
+                group->_exception = std::current_exception();
+            }
+        }
+        group->_count--;
+    }
+
+    void TaskPool::work() {
+        while (true) {
+            Task task;
+            if (pop(task)) {
+                run(task);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(_mutex);
+            _cv.wait(lock, [this]() {
+                return _stop || _pending > 0; //
+            });
+            if (_stop && _pending == 0) {
+                return;
+            }
+        }
+    }
+
+    TaskGroup::TaskGroup(TaskPool *pool) : _pool(pool) {
+    }
+
+    TaskGroup::~TaskGroup() {
+        assert(_count == 0);
+    }
+
+    void TaskGroup::spawn(std::function<void()> func) {
+        _count++;
+        _pool->push({std::move(func), this});
+    }
+
+    void TaskGroup::wait() {
+        while (_count > 0) {
+            TaskPool::Task task;
+            if (_pool->pop(task)) {
+                _pool->run(task);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        if (_exception) {
+            std::rethrow_exception(_exception);
+        }
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,391 @@
+#include "TextNode.h"
+#include "TextNode_p.h"
+
+#include <cassert>
+#include <algorithm>
+
+#include "Model_p.h"
+#include "Node_p.h"
+#include "ContentHash.h"
+
+namespace ss {
+
+    using Summary = TextTraits::summary_type;
+
+    static inline bool isContinuation(char c) {
+        return (static_cast<unsigned char>(c) & 0xC0) == 0x80;
+    }
+
+    static int countChars(std::string_view s) {
+        int res = 0;
+        for (char c : s) {
+            res += !isContinuation(c);
+        }
+        return res;
+    }
+
+    static int countLines(std::string_view s) {
+        return int(std::count(s.begin(), s.end(), '\n'));
+    }
+
+    static inline const Summary &summaryOf(const Treap<TextTraits>::Node *node) {
+        static const Summary identity{};
+        return node ? node->summary : identity;
+    }
+
+    // Debug use
+    static inline bool isCompleteUtf8(std::string_view s) {
+        if (s.empty() || isContinuation(s.front())) {
+            return false;
+        }
+        // Check the length of the last sequence
+        size_t lead = s.size() - 1;
+        while (isContinuation(s[lead]))
+            lead--;
+        auto c = static_cast<unsigned char>(s[lead]);
+        size_t len = c < 0x80 ? 1 : c < 0xE0 ? 2 : c < 0xF0 ? 3 : 4;
+        return s.size() - lead == len;
+    }
+
+    static TextChunk makeChunk(std::string_view s) {
+        return {std::string(s), countChars(s), countLines(s)};
+    }
+
+    // Appends the text as chunks of about equal size, cut on code point boundaries
+    static void appendChunks(Treap<TextTraits> &tree, std::string_view s) {
+        size_t pieces = (s.size() + TextNode::ChunkSize - 1) / TextNode::ChunkSize;
+        while (!s.empty()) {
+            size_t n = (s.size() + pieces - 1) / pieces;
+            while (n < s.size() && isContinuation(s[n]))
+                n--;
+            tree.pushBack(makeChunk(s.substr(0, n)));
+            s.remove_prefix(n);
+            pieces--;
+        }
+    }
+
+    void TextNodePrivate::copy(TextNode *dest, const TextNode *src, bool copyId) {
+        if (copyId) {
+            dest->_id = src->_id;
+        }
+        // Share chunks, they're copied on the first write of either node
+        dest->_tree = src->_tree;
+    }
+
+    TextNode::~TextNode() = default;
+
+    void TextNode::insert(int offset, std::string text) {
+        assert(isWritable());
+        assert(NodePrivate::validateArrayQueryArguments(offset, size()) && !text.empty());
+        assert(isBoundary(offset) && isCompleteUtf8(text));
+
+        auto a = Action::create<TextAction>(
+            actionArena(), Action::TextInsert,
+            std::static_pointer_cast<TextNode>(shared_from_this()), offset, std::move(text));
+        a->execute(false);
+        ModelPrivate::pushAction(_model, std::move(a));
+    }
+
+    void TextNode::remove(int offset, int size) {
+        assert(isWritable());
+        assert(NodePrivate::validateArrayRemoveArguments(offset, size, this->size()));
+        assert(isBoundary(offset) && isBoundary(offset + size));
+
+        auto a = Action::create<TextAction>(
+            actionArena(), Action::TextRemove,
+            std::static_pointer_cast<TextNode>(shared_from_this()), offset, text(offset, size));
+        a->execute(false);
+        ModelPrivate::pushAction(_model, std::move(a));
+    }
+
+    std::string TextNode::text() const {
+        std::string res;
+        res.reserve(size());
+        _tree->forEach([&res](const TextChunk &chunk) {
+            res += chunk.text; //
+        });
+        return res;
+    }
+
+    std::string TextNode::text(int offset, int size) const {
+        assert(offset >= 0 && size >= 0 && offset + size <= this->size());
+
+        std::string res;
+        res.reserve(size);
+        Summary before;
+        auto node = findByte(offset, before);
+        size_t local = offset - before.bytes;
+        for (; node && int(res.size()) < size; node = Tree::next(node)) {
+            res.append(node->value.text, local, size - res.size());
+            local = 0;
+        }
+        return res;
+    }
+
+    int TextNode::lineOffset(int line) const {
+        assert(line >= 0 && line < lineCount());
+        if (line == 0) {
+            return 0;
+        }
+
+        // Find the line feed ending the previous line
+        Summary before;
+        auto node = findLine(line, before);
+        const auto &text = node->value.text;
+        size_t pos = size_t(-1);
+        for (int i = before.lines; i < line; ++i) {
+            pos = text.find('\n', pos + 1);
+        }
+        return before.bytes + int(pos) + 1;
+    }
+
+    int TextNode::lineAt(int offset) const {
+        assert(offset >= 0 && offset <= size());
+
+        Summary before;
+        auto node = findByte(offset, before);
+        if (!node) {
+            return 0;
+        }
+        return before.lines +
+               countLines(std::string_view(node->value.text).substr(0, offset - before.bytes));
+    }
+
+    std::string TextNode::line(int line) const {
+        int begin = lineOffset(line);
+        int end = line + 1 < lineCount() ? lineOffset(line + 1) - 1 : size();
+        return text(begin, end - begin);
+    }
+
+    int TextNode::charOffset(int index) const {
+        assert(index >= 0 && index <= charCount());
+        if (index == charCount()) {
+            return size();
+        }
+
+        Summary before;
+        auto node = findChar(index, before);
+        const auto &text = node->value.text;
+        size_t pos = 0;
+        for (int i = before.chars;; ++pos) {
+            if (!isContinuation(text[pos]) && i++ == index)
+                break;
+        }
+        return before.bytes + int(pos);
+    }
+
+    int TextNode::charIndex(int offset) const {
+        assert(offset >= 0 && offset <= size());
+
+        Summary before;
+        auto node = findByte(offset, before);
+        if (!node) {
+            return 0;
+        }
+        return before.chars +
+               countChars(std::string_view(node->value.text).substr(0, offset - before.bytes));
+    }
+
+    bool TextNode::isBoundary(int offset) const {
+        if (offset <= 0 || offset >= size()) {
+            return offset == 0 || offset == size();
+        }
+        Summary before;
+        auto node = findByte(offset, before);
+        return !isContinuation(node->value.text[offset - before.bytes]);
+    }
+
+    std::shared_ptr<Node> TextNode::clone(bool copyId) const {
+        auto node = std::make_shared<TextNode>(_type);
+        TextNodePrivate::copy(node.get(), this, copyId);
+        return node;
+    }
+
+    void TextNode::hashContent(ContentHasher &hasher) const {
+        // The chunks are split by editing history, the hash only depends on the text
+        hasher.add(uint64_t(size()));
+        forEachChunk([&hasher](std::string_view chunk) {
+            hasher.write(chunk.data(), chunk.size()); //
+        });
+    }
+
+    TextNode::Tree::Node *TextNode::findByte(int offset, Summary &before) const {
+        // Prefer the chunk starting at the offset, the last chunk also holds the end offset
+        auto node = _tree->root();
+        while (node) {
+            const auto &left = summaryOf(node->left);
+            if (offset < before.bytes + left.bytes) {
+                node = node->left;
+                continue;
+            }
+            before = TextTraits::combine(before, left);
+            if (offset < before.bytes + int(node->value.text.size()) || !node->right) {
+                break;
+            }
+            before = TextTraits::combine(before, TextTraits::measure(node->value));
+            node = node->right;
+        }
+        return node;
+    }
+
+    TextNode::Tree::Node *TextNode::findChar(int index, Summary &before) const {
+        auto node = _tree->root();
+        while (node) {
+            const auto &left = summaryOf(node->left);
+            if (index < before.chars + left.chars) {
+                node = node->left;
+                continue;
+            }
+            before = TextTraits::combine(before, left);
+            if (index < before.chars + node->value.chars) {
+                break;
+            }
+            before = TextTraits::combine(before, TextTraits::measure(node->value));
+            node = node->right;
+        }
+        return node;
+    }
+
+    TextNode::Tree::Node *TextNode::findLine(int line, Summary &before) const {
+        // Find the chunk holding the line-th line feed
+        auto node = _tree->root();
+        while (node) {
+            const auto &left = summaryOf(node->left);
+            if (line <= before.lines + left.lines) {
+                node = node->left;
+                continue;
+            }
+            before = TextTraits::combine(before, left);
+            if (line <= before.lines + node->value.lines) {
+                break;
+            }
+            before = TextTraits::combine(before, TextTraits::measure(node->value));
+            node = node->right;
+        }
+        return node;
+    }
+
+    void TextNode::insertText(int offset, std::string_view text) {
+        auto &tree = _tree.detach();
+        Summary before;
+        auto node = findByte(offset, before);
+        if (!node) {
+            appendChunks(tree, text);
+            return;
+        }
+
+        // Fast path: the chunk can hold the text, which covers typing
+        auto &chunk = node->value;
+        size_t local = offset - before.bytes;
+        if (chunk.text.size() + text.size() <= size_t(ChunkSize)) {
+            chunk.text.insert(local, text);
+            chunk.chars += countChars(text);
+            chunk.lines += countLines(text);
+            tree.refresh(node);
+            return;
+        }
+
+        // Rebuild the chunk with the text and split it again
+        std::string s;
+        s.reserve(chunk.text.size() + text.size());
+        s.append(chunk.text, 0, local);
+        s.append(text);
+        s.append(chunk.text, local);
+
+        auto rest = tree.split([&before](const Summary &prefix, const TextChunk &) {
+            return prefix.bytes < before.bytes; //
+        });
+        rest.erase(rest.first());
+        appendChunks(tree, s);
+        tree.append(std::move(rest));
+    }
+
+    void TextNode::removeText(int offset, int size) {
+        auto &tree = _tree.detach();
+        Summary before;
+        auto node = findByte(offset, before);
+        auto &chunk = node->value;
+        size_t local = offset - before.bytes;
+
+        // Fast path: the range lies in one chunk
+        if (local + size <= chunk.text.size()) {
+            if (size_t(size) == chunk.text.size()) {
+                tree.erase(node);
+                return;
+            }
+            std::string_view removed(chunk.text.data() + local, size);
+            chunk.chars -= countChars(removed);
+            chunk.lines -= countLines(removed);
+            chunk.text.erase(local, size);
+
+            // Absorb the next chunk if this one becomes too small
+            auto next = Tree::next(node);
+            if (chunk.text.size() < size_t(ChunkSize / 4) && next &&
+                chunk.text.size() + next->value.text.size() <= size_t(ChunkSize)) {
+                chunk.text += next->value.text;
+                chunk.chars += next->value.chars;
+                chunk.lines += next->value.lines;
+                tree.refresh(node);
+                tree.erase(next);
+                return;
+            }
+            tree.refresh(node);
+            return;
+        }
+
+        // Cut out the chunks covering the range and keep the leftovers at both ends
+        int end = offset + size;
+        auto mid = tree.split([&before](const Summary &prefix, const TextChunk &) {
+            return prefix.bytes < before.bytes; //
+        });
+        auto rest = mid.split([&before, end](const Summary &prefix, const TextChunk &) {
+            return before.bytes + prefix.bytes < end; //
+        });
+
+        auto last = mid.last();
+        size_t tail = end - (before.bytes + mid.summary().bytes - int(last->value.text.size()));
+        std::string s;
+        s.append(mid.first()->value.text, 0, local);
+        s.append(last->value.text, tail);
+        mid.clear();
+
+        if (!rest.empty() && s.size() + rest.first()->value.text.size() <= size_t(ChunkSize)) {
+            s += rest.first()->value.text;
+            rest.erase(rest.first());
+        }
+        appendChunks(tree, s);
+        tree.append(std::move(rest));
+    }
+
+    void TextAction::queryNodes(bool inserted,
+                                const std::function<void(const std::shared_ptr<Node> &)> &add) {
+        (void) inserted;
+        (void) add;
+    }
+
+    void TextAction::execute(bool undo) {
+        auto parent = static_cast<TextNode *>(_parent.get());
+        parent->beginAction();
+
+        // Pre-Propagate signal
+        {
+            ActionNotification n(Notification::ActionAboutToTrigger, this, undo);
+            parent->notify(&n);
+        }
+
+        // Do change
+        if ((_type == TextRemove) ^ undo) {
+            parent->removeText(_offset, int(_text.size()));
+        } else {
+            parent->insertText(_offset, _text);
+        }
+
+        // Post-propagate signal
+        {
+            ActionNotification n(Notification::ActionTriggered, this, undo);
+            parent->notify(&n);
+        }
+        parent->endAction();
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,211 @@
+#include "TimelineNode.h"
+#include "TimelineNode_p.h"
+
+#include <cassert>
+#include <utility>
+
+#include "Model_p.h"
+#include "Node_p.h"
+#include "ContentHash.h"
+
+namespace ss {
+
+    void TimelineNodePrivate::copy(TimelineNode *dest, const TimelineNode *src, bool copyId) {
+        if (copyId) {
+            dest->_id = src->_id;
+        }
+        // Clone children, they're visited in order so they can be appended directly
+        dest->_index.resize(src->_index.size());
+        for (const auto &item : src->data()) {
+            auto newChild = NodePrivate::clone(item.node.get(), copyId);
+            dest->addChild(newChild.get());
+            dest->_index[item.id] =
+                dest->_tree.pushBack({item.id, item.start, item.length, std::move(newChild)});
+        }
+        dest->_size = src->_size;
+        dest->_maxId = src->_maxId;
+    }
+
+    TimelineNode::~TimelineNode() {
+        deferChildren();
+    }
+
+    int TimelineNode::insert(const std::shared_ptr<Node> &node, int start, int length) {
+        assert(isWritable());
+        assert(node && node->isFree());
+        assert(length >= 0);
+
+        int id = _maxId = _maxId + 1;
+        auto a = Action::create<TimelineAction>(
+            actionArena(), Action::TimelineInsert,
+            std::static_pointer_cast<TimelineNode>(shared_from_this()),
+            TimelineItem{id, start, length, node});
+        a->execute(false);
+        ModelPrivate::pushAction(_model, std::move(a));
+        return id;
+    }
+
+    bool TimelineNode::remove(int id) {
+        assert(isWritable());
+
+        auto item = this->item(id);
+        if (!item) {
+            return false;
+        }
+
+        auto a = Action::create<TimelineAction>(
+            actionArena(), Action::TimelineRemove,
+            std::static_pointer_cast<TimelineNode>(shared_from_this()), *item);
+        a->execute(false);
+        ModelPrivate::pushAction(_model, std::move(a));
+        return true;
+    }
+
+    bool TimelineNode::reposition(int id, int start, int length) {
+        assert(isWritable());
+        assert(length >= 0);
+
+        auto item = this->item(id);
+        if (!item) {
+            return false;
+        }
+
+        // Nothing changes
+        if (item->start == start && item->length == length) {
+            return false;
+        }
+
+        auto a = Action::create<TimelineRepositionAction>(
+            actionArena(), std::static_pointer_cast<TimelineNode>(shared_from_this()), id,
+            item->start, item->length, start, length);
+        a->execute(false);
+        ModelPrivate::pushAction(_model, std::move(a));
+        return true;
+    }
+
+    std::vector<int> TimelineNode::overlaps(int begin, int end) const {
+        std::vector<int> res;
+        overlaps(begin, end, [&res](const TimelineItem &item) {
+            res.push_back(item.id); //
+        });
+        return res;
+    }
+
+    std::shared_ptr<Node> TimelineNode::clone(bool copyId) const {
+        auto node = std::make_shared<TimelineNode>(_type);
+        TimelineNodePrivate::copy(node.get(), this, copyId);
+        return node;
+    }
+
+    void TimelineNode::collectChildren(std::vector<Node *> &children) const {
+        _tree.forEach([&children](const TimelineItem &item) {
+            children.push_back(item.node.get()); //
+        });
+    }
+
+    void TimelineNode::hashContent(ContentHasher &hasher) const {
+        _tree.forEach([&hasher](const TimelineItem &item) {
+            hasher.add(item.id);
+            hasher.add(item.start);
+            hasher.add(item.length);
+        });
+    }
+
+    void TimelineNode::insertItem(const TimelineItem &item) {
+        if (size_t(item.id) >= _index.size()) {
+            _index.resize(item.id + 1);
+        }
+        assert(!_index[item.id]);
+
+        // Order by start, then by id
+        _index[item.id] = _tree.insert(
+            [&item](const TimelineTraits::summary_type &, const TimelineItem &other) {
+                return other.start < item.start ||
+                       (other.start == item.start && other.id < item.id);
+            },
+            item);
+        _size++;
+    }
+
+    TimelineItem TimelineNode::removeItem(int id) {
+        auto node = _index[id];
+        assert(node);
+
+        _index[id] = nullptr;
+        _size--;
+        return _tree.erase(node);
+    }
+
+    void TimelineAction::queryNodes(bool inserted,
+                                    const std::function<void(const std::shared_ptr<Node> &)> &add) {
+        if (inserted == (_type == Action::TimelineInsert)) {
+            add(_item.node);
+        }
+    }
+
+    void TimelineAction::execute(bool undo) {
+        auto parent = static_cast<TimelineNode *>(_parent.get());
+
+        parent->beginAction();
+        // Pre-Propagate
+        {
+            ActionNotification n(Notification::ActionAboutToTrigger, this, undo);
+            parent->notify(&n);
+        }
+
+        // Do change
+        if ((_type == TimelineRemove) ^ undo) {
+            assert(parent->nodeAt(_item.id) == _item.node.get());
+            parent->removeChild(_item.node.get());
+            parent->removeItem(_item.id);
+        } else {
+            parent->addChild(_item.node.get());
+            parent->insertItem(_item);
+        }
+
+        // Propagate signal
+        {
+            ActionNotification n(Notification::ActionTriggered, this, undo);
+            parent->notify(&n);
+        }
+
+        parent->endAction();
+    }
+
+    void TimelineRepositionAction::queryNodes(
+        bool inserted, const std::function<void(const std::shared_ptr<Node> &)> &add) {
+        (void) inserted;
+        (void) add;
+    }
+
+    void TimelineRepositionAction::execute(bool undo) {
+        auto parent = static_cast<TimelineNode *>(_parent.get());
+
+        parent->beginAction();
+        // Pre-Propagate
+        {
+            ActionNotification n(Notification::ActionAboutToTrigger, this, undo);
+            parent->notify(&n);
+        }
+
+        // Do change
+        auto item = parent->removeItem(_id);
+        if (undo) {
+            item.start = _oldStart;
+            item.length = _oldLength;
+        } else {
+            item.start = _start;
+            item.length = _length;
+        }
+        parent->insertItem(item);
+
+        // Propagate signal
+        {
+            ActionNotification n(Notification::ActionTriggered, this, undo);
+            parent->notify(&n);
+        }
+
+        parent->endAction();
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,54 @@
+#include "TypedStructNode.h"
+
+#include "Model_p.h"
+#include "Node_p.h"
+
+namespace ss {
+
+    TypedStructNodeBase::~TypedStructNodeBase() = default;
+
+    void TypedStructNodeBase::pushAction(std::unique_ptr<Action> action) {
+        ModelPrivate::pushAction(_model, std::move(action));
+    }
+
+    void TypedStructNodeBase::copyIdFrom(const TypedStructNodeBase *src, bool copyId) {
+        if (copyId) {
+            _id = src->_id;
+        }
+    }
+
+    std::shared_ptr<Node> TypedStructNodeBase::cloneChild(Node *node, bool copyId) {
+        return NodePrivate::clone(node, copyId);
+    }
+
+    void TypedStructActionBase::beginChange(bool undo) {
+        auto parent = static_cast<TypedStructNodeBase *>(_parent.get());
+
+        parent->beginAction();
+        // Pre-Propagate signal
+        {
+            ActionNotification n(Notification::ActionAboutToTrigger, this, undo);
+            parent->notify(&n);
+        }
+    }
+
+    void TypedStructActionBase::endChange(bool undo, Node *oldChild, Node *newChild) {
+        auto parent = static_cast<TypedStructNodeBase *>(_parent.get());
+
+        if (oldChild) {
+            parent->removeChild(oldChild);
+        }
+        if (newChild) {
+            parent->addChild(newChild);
+        }
+
+        // Propagate signal
+        {
+            ActionNotification n(Notification::ActionTriggered, this, undo);
+            parent->notify(&n);
+        }
+
+        parent->endAction();
+    }
+
+}
\ No newline at end of file
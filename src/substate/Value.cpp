@@ -0,0 +1,32 @@
+#include "Value.h"
+
+#include "KeyTable.h"
+
+namespace ss {
+
+    static KeyTable<std::string> &keyTable() {
+        static KeyTable<std::string> table;
+        return table;
+    }
+
+    ValueKey::ValueKey(const std::string &name) : _id(keyTable().intern(name)) {
+    }
+
+    ValueKey ValueKey::find(const std::string &name) {
+        return fromId(keyTable().find(name));
+    }
+
+    const std::string &ValueKey::name() const {
+        static const std::string empty;
+        return _id < 0 ? empty : keyTable().key(_id);
+    }
+
+    void ValueAction::queryNodes(bool inserted,
+                                 const std::function<void(const std::shared_ptr<Node> &)> &add) {
+        const auto &value = inserted ? _value : _oldValue;
+        if (value.isNode()) {
+            add(value.nodeRef());
+        }
+    }
+
+}
\ No newline at end of file
@@ -3,10 +3,12 @@
 
 #include <cassert>
 #include <algorithm>
+#include <iterator>
 #include <utility>
 
 #include "Model_p.h"
 #include "Node_p.h"
+#include "ContentHash.h"
 
 namespace ss {
 
@@ -16,25 +18,100 @@ namespace ss {
         if (dest < index) {
             std::rotate(arr.begin() + dest, arr.begin() + index, arr.begin() + index + count);
         } else {
-            std::rotate(arr.begin() + index, arr.begin() + index + count,
-                        arr.begin() + dest + count);
+            std::rotate(arr.begin() + index, arr.begin() + index + count, arr.begin() + dest);
         }
     }
 
+    // Removes the elements covered by the ascending and disjoint ranges in one pass, the removed
+    // elements are moved to the back of \a out if it's not null.
+    template <class T>
+    static void arrayRemoveRanges(std::vector<T> &arr, const std::vector<VectorRange> &ranges,
+                                  std::vector<T> *out) {
+        auto dst = arr.begin() + ranges.front().index;
+        for (size_t i = 0; i < ranges.size(); ++i) {
+            auto begin = arr.begin() + ranges[i].index;
+            auto end = begin + ranges[i].count;
+            if (out) {
+                std::move(begin, end, std::back_inserter(*out));
+            }
+            auto next = (i + 1 < ranges.size()) ? arr.begin() + ranges[i + 1].index : arr.end();
+            dst = std::move(end, next, dst);
+        }
+        arr.erase(dst, arr.end());
+    }
+
+    // Inverse of arrayRemoveRanges, puts the elements starting from \a items back to the ranges in
+    // one pass.
+    template <class T, class Iterator>
+    static void arrayInsertRanges(std::vector<T> &arr, const std::vector<VectorRange> &ranges,
+                                  int count, Iterator items) {
+        auto oldSize = arr.size();
+        arr.resize(oldSize + count);
+
+        auto src = arr.begin() + oldSize;
+        auto dst = arr.end();
+        auto item = items + count;
+        for (auto it = ranges.rbegin(); it != ranges.rend(); ++it) {
+            auto begin = arr.begin() + it->index;
+            auto end = begin + it->count;
+
+            // Shift the kept elements behind the range
+            auto kept = dst - end;
+            std::move_backward(src - kept, src, dst);
+            src -= kept;
+
+            // Fill the range
+            item -= it->count;
+            std::copy(item, item + it->count, begin);
+            dst = begin;
+        }
+    }
+
+    // Returns the index of the gathered block after moving the ranges to \a dest.
+    static int rangesMoveTarget(const std::vector<VectorRange> &ranges, int dest) {
+        int target = dest;
+        for (const auto &range : ranges) {
+            if (range.index >= dest)
+                break;
+            target -= std::min(range.count, dest - range.index);
+        }
+        return target;
+    }
+
+#ifndef NDEBUG
+    static bool validateRangesArguments(const std::vector<VectorRange> &ranges, int size) {
+        if (ranges.empty())
+            return false;
+        int last = 0;
+        for (const auto &range : ranges) {
+            if (range.index < last || !NodePrivate::validateArrayRemoveArguments(
+                                          range.index, range.count, size)) {
+                return false;
+            }
+            last = range.index + range.count;
+        }
+        return true;
+    }
+#endif
+
     void VectorNodePrivate::copy(VectorNode *dest, const VectorNode *src, bool copyId) {
-        if (!copyId) {
+        if (copyId) {
             dest->_id = src->_id;
         }
-        // Clone children
-        dest->_vec.reserve(src->_vec.size());
-        for (auto &child : src->_vec) {
-            auto newChild = NodePrivate::clone(child.get(), copyId);
-            dest->addChild(newChild.get());
-            dest->_vec.emplace_back(std::move(newChild));
-        }
+        // Clone children, each range fills its own slots
+        dest->_vec.resize(src->_vec.size());
+        NodePrivate::forRanges(src->_vec.size(), [dest, src, copyId](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                auto newChild = NodePrivate::clone(src->_vec[i].get(), copyId);
+                dest->addChild(newChild.get());
+                dest->_vec[i] = std::move(newChild);
+            }
+        });
     }
 
-    VectorNode::~VectorNode() = default;
+    VectorNode::~VectorNode() {
+        deferChildren();
+    }
 
     void VectorNode::insert(int index, std::vector<std::shared_ptr<Node>> nodes) {
         assert(isWritable());
@@ -47,9 +124,9 @@ namespace ss {
         }
 #endif
 
-        auto action = std::make_unique<VectorInsDelAction>(
-            Action::VectorInsert, std::static_pointer_cast<VectorNode>(shared_from_this()), index,
-            std::move(nodes));
+        auto action = Action::create<VectorInsDelAction>(
+            actionArena(), Action::VectorInsert,
+            std::static_pointer_cast<VectorNode>(shared_from_this()), index, std::move(nodes));
         action->execute(false);
         ModelPrivate::pushAction(_model, std::move(action));
     }
@@ -59,8 +136,9 @@ namespace ss {
         assert(NodePrivate::validateArrayRemoveArguments(index, count, _vec.size()) &&
                !(dest >= index && dest < index + count));
 
-        auto action = std::make_unique<VectorMoveAction>(
-            std::static_pointer_cast<VectorNode>(shared_from_this()), index, count, dest);
+        auto action = Action::create<VectorMoveAction>(
+            actionArena(), std::static_pointer_cast<VectorNode>(shared_from_this()), index, count,
+            dest);
         action->execute(false);
         ModelPrivate::pushAction(_model, std::move(action));
     }
@@ -73,25 +151,79 @@ namespace ss {
         nodes.resize(count);
         std::copy(_vec.begin() + index, _vec.begin() + index + count, nodes.begin());
 
-        auto action = std::make_unique<VectorInsDelAction>(
-            Action::VectorRemove, std::static_pointer_cast<VectorNode>(shared_from_this()), index,
-            std::move(nodes));
+        auto action = Action::create<VectorInsDelAction>(
+            actionArena(), Action::VectorRemove,
+            std::static_pointer_cast<VectorNode>(shared_from_this()), index, std::move(nodes));
+        action->execute(false);
+        ModelPrivate::pushAction(_model, std::move(action));
+    }
+
+    void VectorNode::removeRanges(std::vector<VectorRange> ranges) {
+        assert(isWritable());
+        assert(validateRangesArguments(ranges, _vec.size()));
+
+        std::vector<std::shared_ptr<Node>> nodes;
+        for (const auto &range : std::as_const(ranges)) {
+            auto begin = _vec.begin() + range.index;
+            nodes.insert(nodes.end(), begin, begin + range.count);
+        }
+
+        auto action = Action::create<VectorRemoveRangesAction>(
+            actionArena(), std::static_pointer_cast<VectorNode>(shared_from_this()),
+            std::move(ranges), std::move(nodes));
+        action->execute(false);
+        ModelPrivate::pushAction(_model, std::move(action));
+    }
+
+    void VectorNode::moveRanges(std::vector<VectorRange> ranges, int dest) {
+        assert(isWritable());
+        assert(validateRangesArguments(ranges, _vec.size()) &&
+               NodePrivate::validateArrayQueryArguments(dest, _vec.size()));
+
+        auto action = Action::create<VectorMoveRangesAction>(
+            actionArena(), std::static_pointer_cast<VectorNode>(shared_from_this()),
+            std::move(ranges), dest);
         action->execute(false);
         ModelPrivate::pushAction(_model, std::move(action));
     }
 
+    int VectorNode::indexOf(const Node *node) const {
+        int indexed = _indexed.load(std::memory_order_acquire);
+        int index = NodePrivate::indexHint(node);
+        if (index >= 0 && index < indexed && _vec[index].get() == node) {
+            return index;
+        }
+
+        // Refresh the index hints of the outdated tail, concurrent readers write the same values
+        int size = int(_vec.size());
+        for (int i = indexed; i < size; ++i) {
+            NodePrivate::setIndexHint(_vec[i].get(), i);
+        }
+        _indexed.store(size, std::memory_order_release);
+
+        index = NodePrivate::indexHint(node);
+        if (index >= 0 && index < size && _vec[index].get() == node) {
+            return index;
+        }
+        return -1;
+    }
+
     std::shared_ptr<Node> VectorNode::clone(bool copyId) const {
         auto node = std::make_shared<VectorNode>(_type);
         VectorNodePrivate::copy(node.get(), this, copyId);
         return node;
     }
 
-    void VectorNode::propagateChildren(const std::function<void(Node *)> &func) {
+    void VectorNode::collectChildren(std::vector<Node *> &children) const {
         for (const auto &node : std::as_const(_vec)) {
-            NodePrivate::propagate(node.get(), func);
+            children.push_back(node.get());
         }
     }
 
+    void VectorNode::hashContent(ContentHasher &hasher) const {
+        hasher.add(uint64_t(_vec.size()));
+    }
+
     void VectorMoveAction::queryNodes(
         bool inserted, const std::function<void(const std::shared_ptr<Node> &)> &add) {
         (void) inserted;
@@ -105,7 +237,7 @@ namespace ss {
         parent->beginAction();
         // Pre-Propagate signal
         {
-            ActionNotification n(Notification::ActionAboutToTrigger, this);
+            ActionNotification n(Notification::ActionAboutToTrigger, this, undo);
             parent->notify(&n);
         }
 
@@ -125,10 +257,11 @@ namespace ss {
             dest = _dest;
         }
         arrayMove(vec, index, _count, dest);
+        parent->invalidateIndexes(std::min(index, dest));
 
         // Propagate signal
         {
-            ActionNotification n(Notification::ActionTriggered, this);
+            ActionNotification n(Notification::ActionTriggered, this, undo);
             parent->notify(&n);
         }
         parent->endAction();
@@ -150,7 +283,7 @@ namespace ss {
         parent->beginAction();
         // Pre-Propagate signal
         {
-            ActionNotification n(Notification::ActionAboutToTrigger, this);
+            ActionNotification n(Notification::ActionAboutToTrigger, this, undo);
             parent->notify(&n);
         }
 
@@ -168,10 +301,95 @@ namespace ss {
             }
             vec.insert(vec.begin() + _index, _children.begin(), _children.end());
         }
+        parent->invalidateIndexes(_index);
+
+        // Post-propagate signal
+        {
+            ActionNotification n(Notification::ActionTriggered, this, undo);
+            parent->notify(&n);
+        }
+        parent->endAction();
+    }
+
+    void VectorRemoveRangesAction::queryNodes(
+        bool inserted, const std::function<void(const std::shared_ptr<Node> &)> &add) {
+        if (!inserted) {
+            for (const auto &node : std::as_const(_children)) {
+                add(node);
+            }
+        }
+    }
+
+    void VectorRemoveRangesAction::execute(bool undo) {
+        auto parent = static_cast<VectorNode *>(_parent.get());
+        auto &vec = parent->_vec;
+
+        parent->beginAction();
+        // Pre-Propagate signal
+        {
+            ActionNotification n(Notification::ActionAboutToTrigger, this, undo);
+            parent->notify(&n);
+        }
+
+        // Do change
+        if (undo) {
+            for (const auto &node : std::as_const(_children)) {
+                parent->addChild(node.get());
+            }
+            arrayInsertRanges(vec, _ranges, _count, _children.cbegin());
+        } else {
+            for (const auto &node : std::as_const(_children)) {
+                parent->removeChild(node.get());
+            }
+            arrayRemoveRanges<std::shared_ptr<Node>>(vec, _ranges, nullptr);
+        }
+        parent->invalidateIndexes(_ranges.front().index);
+
+        // Post-propagate signal
+        {
+            ActionNotification n(Notification::ActionTriggered, this, undo);
+            parent->notify(&n);
+        }
+        parent->endAction();
+    }
+
+    void VectorMoveRangesAction::queryNodes(
+        bool inserted, const std::function<void(const std::shared_ptr<Node> &)> &add) {
+        (void) inserted;
+        (void) add;
+    }
+
+    void VectorMoveRangesAction::execute(bool undo) {
+        auto parent = static_cast<VectorNode *>(_parent.get());
+        auto &vec = parent->_vec;
+
+        parent->beginAction();
+        // Pre-Propagate signal
+        {
+            ActionNotification n(Notification::ActionAboutToTrigger, this, undo);
+            parent->notify(&n);
+        }
+
+        // Do change
+        int target = rangesMoveTarget(_ranges, _dest);
+        std::vector<std::shared_ptr<Node>> moved;
+        moved.reserve(_count);
+        if (undo) {
+            auto begin = vec.begin() + target;
+            auto end = begin + _count;
+            std::move(begin, end, std::back_inserter(moved));
+            vec.erase(begin, end);
+            arrayInsertRanges(vec, _ranges, _count, std::make_move_iterator(moved.begin()));
+        } else {
+            arrayRemoveRanges(vec, _ranges, &moved);
+            vec.insert(vec.begin() + target, std::make_move_iterator(moved.begin()),
+                       std::make_move_iterator(moved.end()));
+        }
+        parent->invalidateIndexes(std::min(_ranges.front().index, target));
 
         // Post-propagate signal
         {
-            ActionNotification n(Notification::ActionTriggered, this);
+            ActionNotification n(Notification::ActionTriggered, this, undo);
             parent->notify(&n);
         }
         parent->endAction();
@@ -0,0 +1,26 @@
+#ifndef TST_CHECK_H
+#define TST_CHECK_H
+
+#include <cstdio>
+
+// Non-fatal checks shared by the tests, main returns checkResult()
+
+static int failures = 0;
+
+#define CHECK(cond)                                                                                \
+    do {                                                                                           \
+        if (!(cond)) {                                                                             \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);        \
+            failures++;                                                                            \
+        }                                                                                          \
+    } while (false)
+
+static inline int checkResult() {
+    if (failures) {
+        std::fprintf(stderr, "%d checks failed\n", failures);
+        return 1;
+    }
+    return 0;
+}
+
+#endif // TST_CHECK_H
\ No newline at end of file
@@ -0,0 +1,80 @@
+#include <algorithm>
+#include <memory>
+#include <cstdio>
+
+#include <substate/Model.h>
+#include <substate/StandardStorageEngine.h>
+#include <substate/SheetNode.h>
+#include <substate/BytesNode.h>
+
+#include "tst_check.h"
+
+using namespace ss;
+
+// Exposes the page table of the sheet
+class PagedSheet : public SheetNode {
+public:
+    // Allocated pages, released ones are null
+    size_t allocatedPages() const {
+        size_t count = 0;
+        for (const auto &page : _pages) {
+            count += page ? 1 : 0;
+        }
+        return count;
+    }
+
+    size_t pageSlots() const {
+        return _pages.size();
+    }
+
+    static constexpr const size_t Ids = PageSize;
+};
+
+// Inserts and removes a child \a count times next to a long-lived child with a low id, so the
+// live ids stay few while their span keeps growing
+static void churn(int count) {
+    Model model(std::make_unique<StandardStorageEngine>());
+
+    auto sheet = std::make_shared<PagedSheet>();
+    model.beginTransaction();
+    model.setRoot(sheet);
+    model.commitTransaction({});
+    model.beginTransaction();
+    int first = sheet->insert(std::make_shared<BytesNode>(Node::Bytes));
+    model.commitTransaction({});
+
+    size_t maxPages = 0;
+    for (int i = 0; i < count; ++i) {
+        model.beginTransaction();
+        int id = sheet->insert(std::make_shared<BytesNode>(Node::Bytes));
+        sheet->remove(id);
+        model.commitTransaction({});
+
+        if (i % PagedSheet::Ids == 0) {
+            maxPages = std::max(maxPages, sheet->allocatedPages());
+        }
+    }
+
+    // Only the pages of the long-lived child and of the last id stay allocated, the page table
+    // costs one pointer per page of the span
+    CHECK(maxPages <= 2);
+    CHECK(sheet->allocatedPages() <= 2);
+    CHECK(sheet->pageSlots() <= size_t(count + 1) / PagedSheet::Ids + 1);
+
+    CHECK(sheet->size() == 1 && sheet->at(first));
+    CHECK(sheet->data().begin()->first == first && ++sheet->data().begin() == sheet->data().end());
+
+    // Undo some pairs, which restores and removes the ids again
+    for (int i = 0; i < 100; ++i) {
+        model.undo();
+    }
+    CHECK(sheet->allocatedPages() <= 2);
+    CHECK(sheet->size() == 1 && sheet->at(first));
+}
+
+int main() {
+    static constexpr const int Count = 40000;
+
+    churn(Count);
+    return checkResult();
+}
\ No newline at end of file
@@ -0,0 +1,140 @@
+#include <new>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+
+#include <substate/Model.h>
+#include <substate/StandardStorageEngine.h>
+#include <substate/VectorNode.h>
+
+#include <qsubstate/MappingNode.h>
+#include <qsubstate/StructNode.h>
+
+#include "tst_check.h"
+
+using namespace ss;
+
+// Counts every allocation of the process, undo and redo of property actions must not allocate
+static size_t allocationCount = 0;
+
+void *operator new(size_t size) {
+    allocationCount++;
+    if (auto ptr = std::malloc(size ? size : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void *operator new[](size_t size) {
+    allocationCount++;
+    if (auto ptr = std::malloc(size ? size : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+static constexpr const int BatchSize = 10000;
+static constexpr const int StructSize = 64;
+
+// Undoes and redoes the last step, returns the allocations of each direction
+static std::pair<size_t, size_t> measureStep(Model *model) {
+    size_t before = allocationCount;
+    model->undo();
+    size_t undo = allocationCount - before;
+
+    before = allocationCount;
+    model->redo();
+    size_t redo = allocationCount - before;
+    return {undo, redo};
+}
+
+static void report(const char *name, std::pair<size_t, size_t> allocations) {
+    std::printf("%-24s undo: %zu allocations, redo: %zu allocations\n", name,
+                allocations.first, allocations.second);
+    CHECK(allocations.first == 0);
+    CHECK(allocations.second == 0);
+}
+
+int main() {
+    Model model(std::make_unique<StandardStorageEngine>());
+
+    auto root = std::make_shared<VectorNode>();
+    auto map = std::make_shared<MappingNode>();
+    auto st = std::make_shared<StructNode<StructSize>>(Node::User);
+    model.beginTransaction();
+    model.setRoot(root);
+    model.commitTransaction({});
+    model.beginTransaction();
+    root->append(map);
+    root->append(st);
+    model.commitTransaction({});
+
+    // Intern the keys up front, like an application keeping them in static variables
+    std::vector<PropertyKey> keys;
+    keys.reserve(BatchSize);
+    for (int i = 0; i < BatchSize; ++i) {
+        keys.emplace_back(QString::fromUtf8(("key" + std::to_string(i)).c_str()));
+    }
+
+    // A batch of single assignments, one action per key
+    model.beginTransaction();
+    for (int i = 0; i < BatchSize; ++i) {
+        map->setProperty(keys[i], Property(i));
+    }
+    model.commitTransaction({});
+    report("MappingAction", measureStep(&model));
+    CHECK(map->size() == BatchSize && map->property(keys[42]).toInt() == 42);
+
+    // The same keys reassigned by one batch action, with short strings stored inline
+    {
+        std::vector<MappingNode::Entry> entries;
+        entries.reserve(BatchSize);
+        for (int i = 0; i < BatchSize; ++i) {
+            entries.emplace_back(keys[i], (i % 2) ? Property(QString("v")) : Property(-i));
+        }
+        model.beginTransaction();
+        map->setProperties(entries);
+        model.commitTransaction({});
+    }
+    report("MappingBatchAction", measureStep(&model));
+    CHECK(map->property(keys[1]).toString() == QString("v"));
+
+    // Struct fields, one action per field and then one batch action
+    model.beginTransaction();
+    for (int round = 0; round < BatchSize / StructSize; ++round) {
+        for (int i = 0; i < StructSize; ++i) {
+            st->setAt(i, Property(round * StructSize + i));
+        }
+    }
+    model.commitTransaction({});
+    report("StructAction", measureStep(&model));
+
+    {
+        std::vector<Property> values;
+        for (int i = 0; i < StructSize; ++i) {
+            values.emplace_back(i % 3 == 0);
+        }
+        model.beginTransaction();
+        st->setAt(0, values);
+        model.commitTransaction({});
+    }
+    report("StructBatchAction", measureStep(&model));
+    CHECK(st->at(3).toBool() && !st->at(4).toBool());
+
+    return checkResult();
+}
\ No newline at end of file